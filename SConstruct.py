@@ -26,9 +26,17 @@ result_path = os.path.join("addons", "Saveload", "bin")
 
 # Our includes and sources
 env.Append(CPPDEFINES=["GDEXTENSION", "TOOLS_ENABLED"])  # Tells our sources we are building a GDExtension, not a module.
+# The tests in tests/ only run in the engine module build, see SCsub.
 sources = [
     "src/register_types.cpp",
     "src/saveload_api.cpp",
+    "src/saveload_arena.cpp",
+    "src/saveload_chunk_store.cpp",
+    "src/saveload_cipher.cpp",
+    "src/saveload_encoder.cpp",
+    "src/saveload_file_writer.cpp",
+    "src/saveload_path_table.cpp",
+    "src/saveload_simd.cpp",
     "src/saveload_spawner.cpp",
     "src/saveload_synchronizer.cpp",
     "src/scene_saveload.cpp",
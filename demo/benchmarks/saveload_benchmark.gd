@@ -0,0 +1,203 @@
+# Headless throughput benchmark for the Saveload addon.
+#
+# Builds a synthetic world of SaveloadSpawners and SaveloadSynchronizers, then
+# times serialize, deserialize, save and load and reports the results as JSON.
+# Copy the built library into demo/addons/Saveload/bin first, then run:
+#
+#   godot --headless --path demo --script res://benchmarks/saveload_benchmark.gd -- \
+#       --spawners=4 --spawned=250 --synchronizers=1000 --properties=8 --iterations=10 \
+#       --output=user://saveload_benchmark.json
+#
+# Every option is optional. The JSON report is always printed to stdout.
+extends SceneTree
+
+const ACTOR_SCENE_PATH := "user://saveload_benchmark_actor.scn"
+const SAVE_PATH := "user://saveload_benchmark.sav"
+
+var options := {
+	"spawners": 4,
+	"spawned": 250,
+	"synchronizers": 1000,
+	"properties": 8,
+	"iterations": 10,
+	"seed": 0,
+	"instrument": 1,
+	"output": "",
+}
+
+var world: Node3D
+var saveload: Object
+var serialized_state: Variant = null
+var rng := RandomNumberGenerator.new()
+
+
+func _initialize() -> void:
+	_parse_options()
+	saveload = Engine.get_singleton("SaveloadAPI")
+	saveload.instrumentation_enabled = options["instrument"] != 0
+	rng.seed = options["seed"]
+
+	var config := _make_config(options["properties"])
+	_build_world(config)
+
+	var results := {
+		"engine": Engine.get_version_info()["string"],
+		"timestamp": Time.get_datetime_string_from_system(true),
+		"options": options,
+		"world": {
+			"spawners": saveload.get_spawners().size(),
+			"synchronizers": saveload.get_synchers().size(),
+			"properties_per_config": options["properties"],
+		},
+		"operations": {},
+	}
+
+	var operations: Dictionary = results["operations"]
+	operations["serialize"] = _measure(func(): serialized_state = saveload.serialize())
+	operations["deserialize"] = _measure(func(): saveload.deserialize(serialized_state))
+	operations["save"] = _measure(func(): saveload.save(SAVE_PATH))
+	operations["load"] = _measure(func(): saveload.load(SAVE_PATH))
+
+	# Every save after the first reuses the buffers of the one before, so with instrumentation on
+	# the last save should grow none of them, and in a debug build should leave static memory usage
+	# close to where it started.
+	if saveload.instrumentation_enabled:
+		results["steady_state_save_retained_bytes"] = operations["save"]["last_operation_stats"].get("retained_bytes", -1)
+		results["steady_state_save_scratch_allocations"] = operations["save"]["last_operation_stats"].get("scratch_allocations", -1)
+
+	var file := FileAccess.open(SAVE_PATH, FileAccess.READ)
+	results["file_size_bytes"] = file.get_length() if file else -1
+	file = null
+
+	var json := JSON.stringify(results, "\t", false)
+	print(json)
+	if not String(options["output"]).is_empty():
+		var out := FileAccess.open(options["output"], FileAccess.WRITE)
+		if out:
+			out.store_string(json)
+		else:
+			push_error("Could not write benchmark results to %s" % options["output"])
+
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(SAVE_PATH))
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(ACTOR_SCENE_PATH))
+	quit()
+
+
+func _parse_options() -> void:
+	for arg in OS.get_cmdline_user_args():
+		if not arg.begins_with("--") or not "=" in arg:
+			push_warning("Ignoring benchmark argument %s" % arg)
+			continue
+		var key := arg.substr(2, arg.find("=") - 2)
+		var value := arg.substr(arg.find("=") + 1)
+		if not options.has(key):
+			push_warning("Unknown benchmark option %s" % key)
+			continue
+		options[key] = value if options[key] is String else value.to_int()
+
+
+# Times `p_operation` over the configured number of iterations, in microseconds.
+func _measure(p_operation: Callable) -> Dictionary:
+	var samples: Array[int] = []
+	var memory_before := OS.get_static_memory_usage()
+	for i in options["iterations"]:
+		var start := Time.get_ticks_usec()
+		p_operation.call()
+		samples.append(Time.get_ticks_usec() - start)
+	samples.sort()
+	var total := 0
+	for sample in samples:
+		total += sample
+	return {
+		"min_usec": samples[0],
+		"median_usec": samples[samples.size() / 2],
+		"mean_usec": total / samples.size(),
+		"max_usec": samples[-1],
+		"static_memory_delta_bytes": OS.get_static_memory_usage() - memory_before,
+		"last_operation_stats": saveload.get_last_operation_stats() if saveload.instrumentation_enabled else {},
+	}
+
+
+# Synchronized values live in metadata so that any property count and type mix
+# can be generated without custom scripts.
+func _make_config(p_property_count: int) -> SceneSaveloadConfig:
+	var config := SceneSaveloadConfig.new()
+	for i in p_property_count:
+		config.add_property(NodePath(".:metadata/bench_%d" % i))
+	return config
+
+
+func _random_value(p_index: int) -> Variant:
+	match p_index % 10:
+		0:
+			return rng.randf_range(-1000.0, 1000.0)
+		1:
+			return rng.randi()
+		2:
+			return Vector2(rng.randf(), rng.randf()) * 1000.0
+		3:
+			return Vector3(rng.randf(), rng.randf(), rng.randf()) * 1000.0
+		4:
+			return Quaternion(Vector3.UP, rng.randf() * TAU)
+		5:
+			return Transform3D(Basis(Vector3.UP, rng.randf() * TAU), Vector3(rng.randf(), rng.randf(), rng.randf()) * 1000.0)
+		6:
+			return Color(rng.randf(), rng.randf(), rng.randf())
+		7:
+			return "item_%d" % rng.randi_range(0, 4096)
+		8:
+			return rng.randf() < 0.5
+		_:
+			return [rng.randi_range(0, 99), rng.randi_range(0, 99), rng.randi_range(0, 99)]
+
+
+func _make_actor(p_config: SceneSaveloadConfig) -> Node3D:
+	var actor := Node3D.new()
+	actor.name = "Actor"
+	for i in p_config.get_properties().size():
+		actor.set_meta("bench_%d" % i, _random_value(i))
+	var synchronizer := SaveloadSynchronizer.new()
+	synchronizer.name = "SaveloadSynchronizer"
+	synchronizer.saveload_config = p_config
+	actor.add_child(synchronizer)
+	synchronizer.owner = actor
+	return actor
+
+
+func _build_world(p_config: SceneSaveloadConfig) -> void:
+	world = Node3D.new()
+	world.name = "World"
+	root.add_child(world)
+	current_scene = world
+
+	var statics := Node3D.new()
+	statics.name = "Statics"
+	world.add_child(statics)
+	for i in options["synchronizers"]:
+		var actor := _make_actor(p_config)
+		actor.name = "Static%d" % i
+		statics.add_child(actor)
+
+	if options["spawners"] <= 0:
+		return
+	var scene := PackedScene.new()
+	var template := _make_actor(p_config)
+	scene.pack(template)
+	template.free()
+	ResourceSaver.save(scene, ACTOR_SCENE_PATH)
+
+	for s in options["spawners"]:
+		var container := Node3D.new()
+		container.name = "Spawned%d" % s
+		world.add_child(container)
+		var spawner := SaveloadSpawner.new()
+		spawner.name = "SaveloadSpawner%d" % s
+		spawner.spawn_path = NodePath("../" + container.name)
+		spawner.add_spawnable_scene(ACTOR_SCENE_PATH)
+		world.add_child(spawner)
+		var packed: PackedScene = load(ACTOR_SCENE_PATH)
+		for i in options["spawned"]:
+			var actor: Node3D = packed.instantiate()
+			for p in p_config.get_properties().size():
+				actor.set_meta("bench_%d" % p, _random_value(p))
+			container.add_child(actor, true)
@@ -248,7 +248,20 @@ void SaveloadEditor::_add_sync_property(const NodePath &p_path) {
         _update_config();
     }
 
+    // Record the property type so saves can use a typed encoding for it.
+    Variant::Type type = Variant::NIL;
+    Node *root_node = current->get_node_or_null(current->get_root_path());
+    Node *node = root_node ? root_node->get_node_or_null(NodePath(p_path.get_concatenated_names())) : nullptr;
+    if (node) {
+#ifdef GDEXTENSION
+        type = node->get_indexed(NodePath(p_path.get_concatenated_subnames())).get_type();
+#elif
+        type = node->get_indexed(p_path.get_subnames()).get_type();
+#endif
+    }
+
     undo_redo->add_do_method(config.ptr(), "add_property", p_path);
+    undo_redo->add_do_method(config.ptr(), "property_set_type", p_path, type);
     undo_redo->add_undo_method(config.ptr(), "remove_property", p_path);
     undo_redo->add_do_method(this, "_update_config");
     undo_redo->add_undo_method(this, "_update_config");
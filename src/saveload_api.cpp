@@ -43,6 +43,7 @@ void SaveloadAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("deserialize", "serialized_state", "configuration_data"), &SaveloadAPI::deserialize, DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("save", "path", "configuration_data"), &SaveloadAPI::save, DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("load", "path", "configuration_data"), &SaveloadAPI::load, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("validate", "path", "configuration_data"), &SaveloadAPI::validate, DEFVAL(Variant()));
 }
 
 /// SaveloadAPIExtension
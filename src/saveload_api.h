@@ -66,6 +66,8 @@ public:
 
     virtual Error load(const String &p_path, const Variant &p_configuration_data = Variant()) { return ERR_BUG; }
 
+    virtual Error validate(const String &p_path, const Variant &p_configuration_data = Variant()) { return ERR_BUG; }
+
     SaveloadAPI() { singleton = this; }
 
     ~SaveloadAPI() { singleton = nullptr; }
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*  saveload_arena.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "saveload_arena.h"
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/core/memory.hpp>
+
+#elif
+
+#include "core/os/memory.h"
+
+#endif
+
+void *SaveloadArena::alloc(uint32_t p_size, uint32_t p_alignment) {
+	DEV_ASSERT(p_alignment && !(p_alignment & (p_alignment - 1)));
+	for (; block_index < blocks.size(); block_index++, offset = 0) {
+		const Block &block = blocks[block_index];
+		const uint32_t padding = (uint32_t)(-(uintptr_t)(block.data + offset) & (p_alignment - 1));
+		if (block.size - offset >= padding && block.size - offset - padding >= p_size) {
+			void *ptr = block.data + offset + padding;
+			offset += padding + p_size;
+			used += padding + p_size;
+			return ptr;
+		}
+	}
+	// Sizes may come from a file, so one too large for a block fails rather than wrapping around.
+	ERR_FAIL_COND_V_MSG(p_size > UINT32_MAX - p_alignment, nullptr, "Saveload scratch allocation is too large.");
+	Block block;
+	block.size = MAX((uint32_t)MIN_BLOCK_SIZE, p_size + p_alignment);
+	block.data = (uint8_t *)memalloc(block.size);
+	ERR_FAIL_NULL_V_MSG(block.data, nullptr, "Out of memory for saveload scratch data.");
+	blocks.push_back(block);
+	block_index = blocks.size() - 1;
+	const uint32_t padding = (uint32_t)(-(uintptr_t)block.data & (p_alignment - 1));
+	offset = padding + p_size;
+	used += padding + p_size;
+	return block.data + padding;
+}
+
+void SaveloadArena::reset() {
+	if (!used) {
+		// Nothing was used since the last reset, which already sized the arena.
+		return;
+	}
+	const uint64_t target = CLAMP(used, (uint64_t)MIN_BLOCK_SIZE, (uint64_t)MAX_RETAINED_SIZE);
+	const uint64_t capacity = get_capacity();
+	if (blocks.size() > 1 || capacity > target * 4) {
+		clear();
+		Block block;
+		block.size = (uint32_t)target;
+		block.data = (uint8_t *)memalloc(block.size);
+		if (block.data) {
+			blocks.push_back(block);
+		}
+	}
+	block_index = 0;
+	offset = 0;
+	used = 0;
+}
+
+void SaveloadArena::clear() {
+	for (const Block &block : blocks) {
+		memfree(block.data);
+	}
+	blocks.clear();
+	block_index = 0;
+	offset = 0;
+	used = 0;
+}
+
+uint64_t SaveloadArena::get_capacity() const {
+	uint64_t capacity = 0;
+	for (const Block &block : blocks) {
+		capacity += block.size;
+	}
+	return capacity;
+}
@@ -0,0 +1,92 @@
+/**************************************************************************/
+/*  saveload_arena.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAVELOAD_ARENA_H
+#define SAVELOAD_ARENA_H
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/templates/local_vector.h"
+
+#endif
+
+#include <type_traits>
+
+// Monotonic allocator for the raw buffers a load only needs until it is applied. Nothing
+// is freed on its own; reset() rewinds the arena and keeps about as much memory as the last
+// use needed, up to MAX_RETAINED_SIZE, so loads of a similar size stop allocating after the
+// first one. Only holds trivially destructible data.
+class SaveloadArena {
+	struct Block {
+		uint8_t *data = nullptr;
+		uint32_t size = 0;
+	};
+
+	LocalVector<Block> blocks;
+	uint32_t block_index = 0;
+	uint32_t offset = 0; // Into blocks[block_index].
+	uint64_t used = 0; // Bytes handed out since the last reset, padding included.
+
+public:
+	enum {
+		MIN_BLOCK_SIZE = 64 * 1024,
+		MAX_RETAINED_SIZE = 16 * 1024 * 1024, // A single huge load should not pin its memory forever.
+		DEFAULT_ALIGNMENT = 16,
+	};
+
+	void *alloc(uint32_t p_size, uint32_t p_alignment = DEFAULT_ALIGNMENT);
+
+	template <typename T>
+	T *alloc_array(uint32_t p_count) {
+		static_assert(std::is_trivially_destructible<T>::value, "SaveloadArena never runs destructors.");
+		ERR_FAIL_COND_V_MSG(p_count > UINT32_MAX / sizeof(T), nullptr, "Saveload scratch allocation is too large.");
+		return (T *)alloc(p_count * sizeof(T), alignof(T));
+	}
+
+	// Makes all memory available again. The arena ends up as one block sized for the last use:
+	// blocks are merged if it needed several, and the block shrinks if it used under a quarter.
+	void reset();
+	void clear();
+
+	uint64_t get_capacity() const;
+
+	SaveloadArena() {}
+	SaveloadArena(const SaveloadArena &) = delete;
+	SaveloadArena &operator=(const SaveloadArena &) = delete;
+	~SaveloadArena() { clear(); }
+};
+
+#endif // SAVELOAD_ARENA_H
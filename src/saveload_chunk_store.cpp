@@ -0,0 +1,262 @@
+/**************************************************************************/
+/*  saveload_chunk_store.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "saveload_chunk_store.h"
+#include "saveload_encoder.h"
+
+#include <string.h>
+#include <atomic>
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/hashing_context.hpp>
+#include <godot_cpp/classes/os.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/crypto/crypto_core.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+
+#endif
+
+// Random values the rolling hash adds per byte. They decide where chunks end, so changing
+// them would stop new saves from sharing chunks with the ones already in a store.
+struct GearTable {
+	uint64_t values[256];
+
+	GearTable() {
+		uint64_t state = 0x53564C4453564C44; // splitmix64
+		for (int i = 0; i < 256; i++) {
+			state += 0x9E3779B97F4A7C15;
+			uint64_t z = state;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+			values[i] = z ^ (z >> 31);
+		}
+	}
+};
+
+static const GearTable gear_table;
+
+bool SaveloadChunkStore::is_manifest(const PackedByteArray &p_bytes) {
+	if (p_bytes.size() < (int64_t)sizeof(uint32_t)) {
+		return false;
+	}
+	uint32_t magic;
+	memcpy(&magic, p_bytes.ptr(), sizeof(magic));
+	return magic == MANIFEST_MAGIC;
+}
+
+void SaveloadChunkStore::_split(const uint8_t *p_data, uint32_t p_size, LocalVector<uint32_t> &r_ends) {
+	// Each shift pushes older bytes out of the top of the hash, so its top bits only
+	// depend on the last 64 bytes and a boundary moves along with the content around it.
+	const uint64_t mask = ((UINT64_C(1) << AVERAGE_CHUNK_BITS) - 1) << (64 - AVERAGE_CHUNK_BITS);
+	uint32_t start = 0;
+	while (start < p_size) {
+		const uint32_t remaining = p_size - start;
+		if (remaining <= MIN_CHUNK_SIZE) {
+			r_ends.push_back(p_size);
+			break;
+		}
+		const uint32_t limit = MIN(remaining, (uint32_t)MAX_CHUNK_SIZE);
+		uint32_t end = start + limit;
+		uint64_t hash = 0;
+		for (uint32_t i = MIN_CHUNK_SIZE; i < limit; i++) {
+			hash = (hash << 1) + gear_table.values[p_data[start + i]];
+			if (!(hash & mask)) {
+				end = start + i + 1;
+				break;
+			}
+		}
+		r_ends.push_back(end);
+		start = end;
+	}
+}
+
+void SaveloadChunkStore::_hash(const uint8_t *p_data, uint32_t p_size, uint8_t r_hash[HASH_SIZE]) {
+#ifdef GDEXTENSION
+	PackedByteArray data;
+	data.resize(p_size);
+	memcpy(data.ptrw(), p_data, p_size);
+	Ref<HashingContext> context;
+	context.instantiate();
+	context->start(HashingContext::HASH_SHA256);
+	context->update(data);
+	const PackedByteArray digest = context->finish();
+	memcpy(r_hash, digest.ptr(), HASH_SIZE);
+#elif
+	CryptoCore::sha256(p_data, p_size, r_hash);
+#endif
+}
+
+// Numbers the temporary files of this process, so that a save and the queued save task
+// storing the same new chunk never write to the same file.
+static std::atomic<uint32_t> temp_file_counter(0);
+
+static String _get_temp_path(const String &p_path) {
+	return vformat("%s.%d-%d.tmp", p_path, OS::get_singleton()->get_process_id(), temp_file_counter.fetch_add(1));
+}
+
+static void _remove_file(const String &p_path) {
+#ifdef GDEXTENSION
+	DirAccess::remove_absolute(p_path);
+#elif
+	DirAccess::create(DirAccess::ACCESS_FILESYSTEM)->remove(p_path);
+#endif
+}
+
+String SaveloadChunkStore::_get_chunk_path(const String &p_directory, const uint8_t p_hash[HASH_SIZE], bool p_compressed) {
+	static const char digits[] = "0123456789abcdef";
+	char name[HASH_SIZE * 2 + 1];
+	for (int i = 0; i < HASH_SIZE; i++) {
+		name[i * 2] = digits[p_hash[i] >> 4];
+		name[i * 2 + 1] = digits[p_hash[i] & 0xF];
+	}
+	name[HASH_SIZE * 2] = 0;
+	return p_directory.path_join(String(name) + (p_compressed ? ".chunkz" : ".chunk"));
+}
+
+Error SaveloadChunkStore::store(const PackedByteArray &p_bytes, const String &p_directory, int p_compression, PackedByteArray &r_manifest, uint64_t &r_written) {
+	ERR_FAIL_COND_V_MSG(p_directory.is_empty(), ERR_INVALID_PARAMETER, "A chunk store needs a directory.");
+	Error err = DirAccess::make_dir_recursive_absolute(p_directory);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not create chunk store directory %s.", p_directory));
+
+	const bool compressed = p_compression >= 0 && p_compression != SaveloadEncoder::COMPRESSION_NONE;
+	const uint8_t *data = p_bytes.ptr();
+	LocalVector<uint32_t> ends;
+	_split(data, p_bytes.size(), ends);
+
+	SaveloadWriter manifest;
+	manifest.put_u32(MANIFEST_MAGIC);
+	manifest.put_u32(MANIFEST_VERSION);
+	manifest.put_u8(compressed ? p_compression : SaveloadEncoder::COMPRESSION_NONE);
+	manifest.put_u32(p_bytes.size());
+	manifest.put_string(p_directory);
+	manifest.put_u32(ends.size());
+
+	r_written = 0;
+	uint32_t start = 0;
+	for (const uint32_t end : ends) {
+		uint8_t hash[HASH_SIZE];
+		_hash(data + start, end - start, hash);
+		manifest.put_data(hash, HASH_SIZE);
+		manifest.put_u32(end - start);
+
+		const String path = _get_chunk_path(p_directory, hash, compressed);
+		if (!FileAccess::file_exists(path)) {
+			// Written under a temporary name first, as a torn chunk under its real name
+			// would be reused by every later save.
+			const String temp_path = _get_temp_path(path);
+			Ref<FileAccess> file = compressed ? FileAccess::open_compressed(temp_path, FileAccess::WRITE, (FileAccess::CompressionMode)p_compression) : FileAccess::open(temp_path, FileAccess::WRITE);
+			ERR_FAIL_COND_V_MSG(file.is_null(), ERR_FILE_CANT_WRITE, vformat("Could not write chunk %s.", path));
+			file->store_buffer(p_bytes.slice(start, end));
+			err = file->get_error();
+			file->close();
+			if (err != OK) {
+				_remove_file(temp_path);
+				ERR_FAIL_V_MSG(ERR_FILE_CANT_WRITE, vformat("Could not write chunk %s.", path));
+			}
+#ifdef GDEXTENSION
+			err = DirAccess::rename_absolute(temp_path, path);
+#elif
+			err = DirAccess::create(DirAccess::ACCESS_FILESYSTEM)->rename(temp_path, path);
+#endif
+			if (err == OK) {
+				r_written += end - start;
+			} else {
+				_remove_file(temp_path);
+				// Another writer may have stored the same chunk meanwhile, which is just as good.
+				ERR_FAIL_COND_V_MSG(!FileAccess::file_exists(path), err, vformat("Could not write chunk %s.", path));
+			}
+		}
+		start = end;
+	}
+
+	r_manifest.resize(manifest.size());
+	memcpy(r_manifest.ptrw(), manifest.ptr(), manifest.size());
+	return OK;
+}
+
+Error SaveloadChunkStore::restore(const PackedByteArray &p_manifest, const String &p_directory, PackedByteArray &r_bytes) {
+	SaveloadReader reader(p_manifest.ptr(), p_manifest.size());
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != MANIFEST_MAGIC, ERR_FILE_UNRECOGNIZED, "Not a saveload manifest.");
+	const uint32_t version = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(version != MANIFEST_VERSION, ERR_FILE_UNRECOGNIZED, vformat("Saveload manifest version %d is not the supported version %d.", version, MANIFEST_VERSION));
+	const uint8_t compression = reader.get_u8();
+	const bool compressed = compression != SaveloadEncoder::COMPRESSION_NONE;
+	const uint32_t total_size = reader.get_u32();
+	const String recorded_directory = reader.get_string();
+	const String directory = p_directory.is_empty() ? recorded_directory : p_directory;
+	const uint32_t chunk_count = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(reader.has_overrun() || chunk_count > reader.get_remaining() / (HASH_SIZE + sizeof(uint32_t)), ERR_FILE_CORRUPT, "Saveload manifest is truncated.");
+
+	// The total size comes from the file, so it has to match the chunks before anything is
+	// allocated for it. No chunk is larger than MAX_CHUNK_SIZE, which bounds the total by the
+	// manifest's own size.
+	SaveloadReader sizes = reader;
+	uint64_t chunk_total = 0;
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		sizes.get_span(HASH_SIZE);
+		const uint32_t size = sizes.get_u32();
+		ERR_FAIL_COND_V_MSG(size > MAX_CHUNK_SIZE, ERR_FILE_CORRUPT, "Saveload manifest is corrupt.");
+		chunk_total += size;
+	}
+	ERR_FAIL_COND_V_MSG(sizes.has_overrun() || chunk_total != total_size, ERR_FILE_CORRUPT, "Saveload manifest chunks do not add up to the save size.");
+
+	r_bytes.resize(total_size);
+	uint8_t *w = r_bytes.ptrw();
+	uint32_t offset = 0;
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		const uint8_t *hash = reader.get_span(HASH_SIZE);
+		const uint32_t size = reader.get_u32();
+		ERR_FAIL_COND_V_MSG(reader.has_overrun() || size > total_size - offset, ERR_FILE_CORRUPT, "Saveload manifest is corrupt.");
+
+		const String path = _get_chunk_path(directory, hash, compressed);
+		Ref<FileAccess> file = compressed ? FileAccess::open_compressed(path, FileAccess::READ, (FileAccess::CompressionMode)compression) : FileAccess::open(path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(file.is_null(), ERR_FILE_NOT_FOUND, vformat("Missing chunk %s.", path));
+		const PackedByteArray chunk = file->get_buffer(size);
+		ERR_FAIL_COND_V_MSG((uint32_t)chunk.size() != size, ERR_FILE_CORRUPT, vformat("Chunk %s is truncated.", path));
+		// Chunks are shared by every save that contains them, so a damaged one is caught here
+		// rather than quietly loading wrong values.
+		uint8_t chunk_hash[HASH_SIZE];
+		_hash(chunk.ptr(), size, chunk_hash);
+		ERR_FAIL_COND_V_MSG(memcmp(chunk_hash, hash, HASH_SIZE) != 0, ERR_FILE_CORRUPT, vformat("Chunk %s does not match its hash.", path));
+		memcpy(w + offset, chunk.ptr(), size);
+		offset += size;
+	}
+	ERR_FAIL_COND_V_MSG(offset != total_size, ERR_FILE_CORRUPT, "Saveload manifest chunks do not add up to the save size.");
+	return OK;
+}
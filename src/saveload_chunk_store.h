@@ -0,0 +1,86 @@
+/**************************************************************************/
+/*  saveload_chunk_store.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAVELOAD_CHUNK_STORE_H
+#define SAVELOAD_CHUNK_STORE_H
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+#endif
+
+// Content-addressed storage for save history. A save is cut into chunks wherever a
+// rolling hash of its bytes hits a boundary pattern, so an edit only changes the chunks
+// around it, and each chunk is stored once in a directory under its SHA-256. The file
+// at the save path becomes a manifest listing the chunks to join back up.
+//
+// Manifest layout:
+//   u32 magic, u32 version, u8 compression, u32 total size, string chunk directory
+//   u32 chunk count, then for each chunk: 32 byte SHA-256, u32 size
+class SaveloadChunkStore {
+public:
+	enum {
+		MANIFEST_MAGIC = 0x4D4C5653, // "SVLM"
+		MANIFEST_VERSION = 1,
+		HASH_SIZE = 32,
+		MIN_CHUNK_SIZE = 2 * 1024,
+		AVERAGE_CHUNK_BITS = 13, // 8 KiB on average.
+		MAX_CHUNK_SIZE = 64 * 1024,
+	};
+
+	static bool is_manifest(const PackedByteArray &p_bytes);
+
+	// Writes the chunks of p_bytes that p_directory does not have yet, compressed with
+	// the FileAccess::CompressionMode p_compression unless it is negative, and returns
+	// the manifest. r_written is the number of chunk bytes actually written.
+	static Error store(const PackedByteArray &p_bytes, const String &p_directory, int p_compression, PackedByteArray &r_manifest, uint64_t &r_written);
+
+	// Joins the chunks listed in p_manifest back up. If p_directory is empty, the
+	// directory recorded in the manifest is used.
+	static Error restore(const PackedByteArray &p_manifest, const String &p_directory, PackedByteArray &r_bytes);
+
+private:
+	static void _split(const uint8_t *p_data, uint32_t p_size, LocalVector<uint32_t> &r_ends);
+	static void _hash(const uint8_t *p_data, uint32_t p_size, uint8_t r_hash[HASH_SIZE]);
+	static String _get_chunk_path(const String &p_directory, const uint8_t p_hash[HASH_SIZE], bool p_compressed);
+};
+
+#endif // SAVELOAD_CHUNK_STORE_H
@@ -0,0 +1,256 @@
+/**************************************************************************/
+/*  saveload_cipher.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "saveload_cipher.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/classes/aes_context.hpp>
+#include <godot_cpp/classes/crypto.hpp>
+#include <godot_cpp/classes/hashing_context.hpp>
+#include <godot_cpp/classes/hmac_context.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/crypto/aes_context.h"
+#include "core/crypto/crypto.h"
+#include "core/crypto/hashing_context.h"
+
+#endif
+
+bool SaveloadCipher::is_encrypted(const PackedByteArray &p_bytes) {
+	if (p_bytes.size() < (int64_t)sizeof(uint32_t)) {
+		return false;
+	}
+	uint32_t magic;
+	memcpy(&magic, p_bytes.ptr(), sizeof(magic));
+	return magic == MAGIC;
+}
+
+Error SaveloadCipher::check_size(const PackedByteArray &p_header, uint64_t p_file_size) {
+	ERR_FAIL_COND_V_MSG(p_header.size() < HEADER_SIZE, ERR_FILE_CORRUPT, "Encrypted saveload file is truncated.");
+	const uint8_t *r = p_header.ptr();
+	uint32_t magic;
+	uint32_t version;
+	uint32_t block_size;
+	uint64_t size;
+	memcpy(&magic, r, sizeof(magic));
+	memcpy(&version, r + 4, sizeof(version));
+	memcpy(&block_size, r + 8, sizeof(block_size));
+	memcpy(&size, r + 12, sizeof(size));
+	ERR_FAIL_COND_V_MSG(magic != MAGIC, ERR_FILE_UNRECOGNIZED, "Not an encrypted saveload file.");
+	ERR_FAIL_COND_V_MSG(version != VERSION, ERR_FILE_UNRECOGNIZED, vformat("Encrypted saveload file version %d is not the supported version %d.", version, VERSION));
+	ERR_FAIL_COND_V_MSG(block_size == 0 || block_size % AES_BLOCK_SIZE, ERR_FILE_CORRUPT, "Encrypted saveload file has an invalid block size.");
+	// Counters are 32-bit, one per AES block of the whole file.
+	ERR_FAIL_COND_V_MSG(size / AES_BLOCK_SIZE >= UINT32_MAX, ERR_FILE_CORRUPT, "Encrypted saveload file is too large.");
+	const uint64_t blocks = (size + block_size - 1) / block_size;
+	ERR_FAIL_COND_V_MSG(p_file_size != HEADER_SIZE + size + blocks * MAC_SIZE, ERR_FILE_CORRUPT, "Encrypted saveload file size does not match its header.");
+	return OK;
+}
+
+PackedByteArray SaveloadCipher::_hmac(const PackedByteArray &p_key, const PackedByteArray &p_data) {
+#ifdef GDEXTENSION
+	Ref<HMACContext> context;
+	context.instantiate();
+#elif
+	Ref<HMACContext> context = Ref<HMACContext>(HMACContext::create());
+	ERR_FAIL_COND_V(context.is_null(), PackedByteArray());
+#endif
+	context->start(HashingContext::HASH_SHA256, p_key);
+	context->update(p_data);
+	return context->finish();
+}
+
+bool SaveloadCipher::_equal_macs(const PackedByteArray &p_mac, const uint8_t *p_expected) {
+	if (p_mac.size() != MAC_SIZE) {
+		return false;
+	}
+	// Constant time, so that timing does not reveal how much of a forged MAC was right.
+	const uint8_t *mac = p_mac.ptr();
+	uint8_t difference = 0;
+	for (int i = 0; i < MAC_SIZE; i++) {
+		difference |= mac[i] ^ p_expected[i];
+	}
+	return difference == 0;
+}
+
+void SaveloadCipher::_derive_keys(const PackedByteArray &p_key) {
+	encryption_key = _hmac(p_key, String("SVLE encryption").to_utf8_buffer());
+	authentication_key = _hmac(p_key, String("SVLE authentication").to_utf8_buffer());
+}
+
+void SaveloadCipher::_counter_blocks(uint32_t p_block, uint32_t p_size, PackedByteArray &r_counters) const {
+	const uint32_t count = (p_size + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+	r_counters.resize(count * AES_BLOCK_SIZE);
+	uint8_t *w = r_counters.ptrw();
+	const uint32_t first = p_block * (block_size / AES_BLOCK_SIZE);
+	for (uint32_t i = 0; i < count; i++) {
+		const uint32_t counter = first + i;
+		memcpy(w + i * AES_BLOCK_SIZE, nonce.ptr(), NONCE_SIZE);
+		memcpy(w + i * AES_BLOCK_SIZE + NONCE_SIZE, &counter, sizeof(counter));
+	}
+}
+
+PackedByteArray SaveloadCipher::_block_mac(uint32_t p_block, const uint8_t *p_ciphertext, uint32_t p_size) const {
+	PackedByteArray data;
+	data.resize(NONCE_SIZE + sizeof(uint32_t) + p_size);
+	uint8_t *w = data.ptrw();
+	memcpy(w, nonce.ptr(), NONCE_SIZE);
+	memcpy(w + NONCE_SIZE, &p_block, sizeof(p_block));
+	memcpy(w + NONCE_SIZE + sizeof(uint32_t), p_ciphertext, p_size);
+	return _hmac(authentication_key, data);
+}
+
+Error SaveloadCipher::begin_encrypt(const PackedByteArray &p_bytes, const PackedByteArray &p_key) {
+	ERR_FAIL_COND_V_MSG(p_key.is_empty(), ERR_INVALID_PARAMETER, "Encrypting a saveload file needs a key.");
+	ERR_FAIL_COND_V_MSG((uint64_t)p_bytes.size() / AES_BLOCK_SIZE >= UINT32_MAX, ERR_INVALID_PARAMETER, "Saveload file is too large to encrypt.");
+#ifdef GDEXTENSION
+	Ref<Crypto> crypto;
+	crypto.instantiate();
+#elif
+	Ref<Crypto> crypto = Ref<Crypto>(Crypto::create());
+	ERR_FAIL_COND_V(crypto.is_null(), ERR_UNAVAILABLE);
+#endif
+	nonce = crypto->generate_random_bytes(NONCE_SIZE);
+	ERR_FAIL_COND_V(nonce.size() != NONCE_SIZE, ERR_CANT_CREATE);
+	_derive_keys(p_key);
+	decrypting = false;
+	block_size = BLOCK_SIZE;
+	plain_size = p_bytes.size();
+	block_count = (plain_size + block_size - 1) / block_size;
+	block_failed.resize(block_count);
+	for (uint8_t &failed : block_failed) {
+		failed = 0;
+	}
+	result.resize(HEADER_SIZE + plain_size + (uint64_t)block_count * MAC_SIZE);
+	output = result.ptrw();
+	input = p_bytes.ptr();
+
+	const uint32_t magic = MAGIC;
+	const uint32_t version = VERSION;
+	memcpy(output, &magic, sizeof(magic));
+	memcpy(output + 4, &version, sizeof(version));
+	memcpy(output + 8, &block_size, sizeof(block_size));
+	memcpy(output + 12, &plain_size, sizeof(plain_size));
+	memcpy(output + 20, nonce.ptr(), NONCE_SIZE);
+	const PackedByteArray header_mac = _hmac(authentication_key, result.slice(0, HEADER_SIZE - MAC_SIZE));
+	ERR_FAIL_COND_V(header_mac.size() != MAC_SIZE, ERR_CANT_CREATE);
+	memcpy(output + HEADER_SIZE - MAC_SIZE, header_mac.ptr(), MAC_SIZE);
+	return OK;
+}
+
+Error SaveloadCipher::begin_decrypt(const PackedByteArray &p_bytes, const PackedByteArray &p_key) {
+	ERR_FAIL_COND_V_MSG(p_key.is_empty(), ERR_UNAUTHORIZED, "Saveload file is encrypted, but no encryption_key was given.");
+	Error err = check_size(p_bytes, p_bytes.size());
+	if (err != OK) {
+		return err;
+	}
+	const uint8_t *r = p_bytes.ptr();
+	memcpy(&block_size, r + 8, sizeof(block_size));
+	memcpy(&plain_size, r + 12, sizeof(plain_size));
+	nonce = p_bytes.slice(20, 20 + NONCE_SIZE);
+	_derive_keys(p_key);
+	ERR_FAIL_COND_V_MSG(!_equal_macs(_hmac(authentication_key, p_bytes.slice(0, HEADER_SIZE - MAC_SIZE)), r + HEADER_SIZE - MAC_SIZE), ERR_FILE_CORRUPT, "Saveload file failed authentication: the key is wrong or the file was modified.");
+	decrypting = true;
+	block_count = (plain_size + block_size - 1) / block_size;
+	block_failed.resize(block_count);
+	for (uint8_t &failed : block_failed) {
+		failed = 0;
+	}
+	result.resize(plain_size);
+	output = result.ptrw();
+	input = r;
+	return OK;
+}
+
+void SaveloadCipher::process_block(uint32_t p_block) {
+	const uint64_t offset = (uint64_t)p_block * block_size;
+	const uint32_t size = MIN((uint64_t)block_size, plain_size - offset);
+	const uint64_t file_offset = HEADER_SIZE + (uint64_t)p_block * (block_size + MAC_SIZE);
+	const uint8_t *src = input + (decrypting ? file_offset : offset);
+	uint8_t *dst = output + (decrypting ? offset : file_offset);
+	// Encrypt-then-MAC: no ciphertext is decrypted before it authenticates.
+	if (decrypting && !_equal_macs(_block_mac(p_block, src, size), src + size)) {
+		block_failed[p_block] = 1;
+		return;
+	}
+	PackedByteArray counters;
+	_counter_blocks(p_block, size, counters);
+	Ref<AESContext> aes;
+	aes.instantiate();
+	if (aes->start(AESContext::MODE_ECB_ENCRYPT, encryption_key) != OK) {
+		block_failed[p_block] = 1;
+		return;
+	}
+	const PackedByteArray keystream = aes->update(counters);
+	aes->finish();
+	if (keystream.size() != counters.size()) {
+		block_failed[p_block] = 1;
+		return;
+	}
+	const uint8_t *k = keystream.ptr();
+	for (uint32_t i = 0; i < size; i++) {
+		dst[i] = src[i] ^ k[i];
+	}
+	if (!decrypting) {
+		const PackedByteArray mac = _block_mac(p_block, dst, size);
+		if (mac.size() != MAC_SIZE) {
+			block_failed[p_block] = 1;
+			return;
+		}
+		memcpy(dst + size, mac.ptr(), MAC_SIZE);
+	}
+}
+
+void SaveloadCipher::process_all() {
+	for (uint32_t i = 0; i < block_count; i++) {
+		process_block(i);
+	}
+}
+
+Error SaveloadCipher::finish(PackedByteArray &r_bytes) {
+	input = nullptr;
+	output = nullptr;
+	for (const uint8_t failed : block_failed) {
+		if (failed) {
+			result = PackedByteArray();
+			ERR_FAIL_COND_V_MSG(decrypting, ERR_FILE_CORRUPT, "Saveload file failed authentication: the key is wrong or the file was modified.");
+			ERR_FAIL_V_MSG(ERR_CANT_CREATE, "Unable to encrypt saveload file.");
+		}
+	}
+	r_bytes = result;
+	result = PackedByteArray();
+	return OK;
+}
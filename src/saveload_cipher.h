@@ -0,0 +1,114 @@
+/**************************************************************************/
+/*  saveload_cipher.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAVELOAD_CIPHER_H
+#define SAVELOAD_CIPHER_H
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+#endif
+
+// Authenticated encryption of whole save files, one block at a time so that blocks can be
+// processed in parallel. Godot exposes no AES-GCM, so each block is encrypted with AES-256 in
+// counter mode, built on ECB, then authenticated with HMAC-SHA256 over the file nonce, the block
+// index and the ciphertext. The header, which fixes the size and so the block count, has its
+// own HMAC, so truncated, reordered or spliced files are rejected.
+//
+// Layout:
+//   u32 magic, u32 version, u32 block size, u64 plaintext size, 12 byte nonce, 32 byte header HMAC
+//   then for each block: ciphertext, 32 byte HMAC
+//
+// Encryption and authentication keys are both derived from the caller's key with HMAC-SHA256.
+class SaveloadCipher {
+public:
+	enum {
+		MAGIC = 0x454C5653, // "SVLE"
+		VERSION = 1,
+		BLOCK_SIZE = 256 * 1024,
+		NONCE_SIZE = 12,
+		MAC_SIZE = 32,
+		HEADER_SIZE = 32 + MAC_SIZE,
+		AES_BLOCK_SIZE = 16,
+	};
+
+private:
+	PackedByteArray encryption_key;
+	PackedByteArray authentication_key;
+	PackedByteArray nonce;
+	const uint8_t *input = nullptr; // Plaintext when encrypting, the file when decrypting.
+	uint8_t *output = nullptr;
+	PackedByteArray result;
+	uint64_t plain_size = 0;
+	uint32_t block_size = BLOCK_SIZE;
+	uint32_t block_count = 0;
+	bool decrypting = false;
+	LocalVector<uint8_t> block_failed; // One flag per block, so blocks never share a write.
+
+	void _derive_keys(const PackedByteArray &p_key);
+	void _counter_blocks(uint32_t p_block, uint32_t p_size, PackedByteArray &r_counters) const;
+	PackedByteArray _block_mac(uint32_t p_block, const uint8_t *p_ciphertext, uint32_t p_size) const;
+
+	static PackedByteArray _hmac(const PackedByteArray &p_key, const PackedByteArray &p_data);
+	static bool _equal_macs(const PackedByteArray &p_mac, const uint8_t *p_expected);
+
+public:
+	static bool is_encrypted(const PackedByteArray &p_bytes);
+
+	// Checks an encrypted file's header and size against each other without a key.
+	static Error check_size(const PackedByteArray &p_header, uint64_t p_file_size);
+
+	// Prepares to encrypt p_bytes, or to decrypt the encrypted file p_bytes, with p_key.
+	// p_bytes must stay alive until finish().
+	Error begin_encrypt(const PackedByteArray &p_bytes, const PackedByteArray &p_key);
+	Error begin_decrypt(const PackedByteArray &p_bytes, const PackedByteArray &p_key);
+
+	uint32_t get_block_count() const { return block_count; }
+
+	// Safe to call for different blocks at the same time.
+	void process_block(uint32_t p_block);
+
+	// Processes every block on the calling thread.
+	void process_all();
+
+	// Returns the encrypted file or the plaintext. Fails if any block did not authenticate.
+	Error finish(PackedByteArray &r_bytes);
+};
+
+#endif // SAVELOAD_CIPHER_H
@@ -0,0 +1,1346 @@
+/**************************************************************************/
+/*  saveload_encoder.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "saveload_encoder.h"
+#include "saveload_chunk_store.h"
+#include "saveload_cipher.h"
+#include "saveload_simd.h"
+
+#include <string.h>
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/io/compression.h"
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+
+#endif
+
+/************************************
+ * SaveloadWriter Definitions Start *
+ ************************************/
+
+void SaveloadWriter::_grow(uint32_t p_size) {
+	capacity = next_power_of_2(MAX(p_size, capacity * 2));
+	data.reserve(capacity);
+	grow_count++;
+}
+
+void SaveloadWriter::put_data(const void *p_data, uint32_t p_size) {
+	const uint32_t position = data.size();
+	if (position + p_size > capacity) {
+		_grow(position + p_size);
+	}
+	data.resize(position + p_size);
+	memcpy(data.ptr() + position, p_data, p_size);
+}
+
+void SaveloadWriter::put_string(const String &p_string) {
+	const CharString utf8 = p_string.utf8();
+	put_u32(utf8.length());
+	put_data(utf8.get_data(), utf8.length());
+}
+
+/**********************************
+ * SaveloadWriter Definitions End *
+ **********************************/
+
+/************************************
+ * SaveloadReader Definitions Start *
+ ************************************/
+
+const uint8_t *SaveloadReader::get_span(uint32_t p_size) {
+	if (overrun || p_size > size - position) {
+		overrun = true;
+		return nullptr;
+	}
+	const uint8_t *span = data + position;
+	position += p_size;
+	return span;
+}
+
+bool SaveloadReader::get_data(void *r_data, uint32_t p_size) {
+	const uint8_t *span = get_span(p_size);
+	if (!span) {
+		memset(r_data, 0, p_size);
+		return false;
+	}
+	memcpy(r_data, span, p_size);
+	return true;
+}
+
+uint8_t SaveloadReader::get_u8() {
+	uint8_t value;
+	get_data(&value, sizeof(value));
+	return value;
+}
+
+uint16_t SaveloadReader::get_u16() {
+	uint16_t value;
+	get_data(&value, sizeof(value));
+	return value;
+}
+
+uint32_t SaveloadReader::get_u32() {
+	uint32_t value;
+	get_data(&value, sizeof(value));
+	return value;
+}
+
+uint64_t SaveloadReader::get_u64() {
+	uint64_t value;
+	get_data(&value, sizeof(value));
+	return value;
+}
+
+float SaveloadReader::get_float() {
+	float value;
+	get_data(&value, sizeof(value));
+	return value;
+}
+
+double SaveloadReader::get_double() {
+	double value;
+	get_data(&value, sizeof(value));
+	return value;
+}
+
+real_t SaveloadReader::get_real(uint8_t p_real_size) {
+	if (p_real_size == sizeof(double)) {
+		return (real_t)get_double();
+	}
+	return (real_t)get_float();
+}
+
+String SaveloadReader::get_string() {
+	const uint32_t length = get_u32();
+	const uint8_t *span = get_span(length);
+	return span ? String::utf8((const char *)span, length) : String();
+}
+
+/**********************************
+ * SaveloadReader Definitions End *
+ **********************************/
+
+/******************************
+ * Quantization Helpers Start *
+ ******************************/
+
+static uint16_t _float_to_half(float p_value) {
+	uint32_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	const uint32_t float_exponent = (bits >> 23) & 0xFF;
+	const int32_t exponent = (int32_t)float_exponent - 127 + 15;
+	uint32_t mantissa = bits & 0x7FFFFF;
+	if (float_exponent == 0xFF) {
+		return sign | 0x7C00 | (mantissa ? 0x200 : 0); // Inf or NaN.
+	}
+	if (exponent >= 0x1F) {
+		return sign | 0x7C00; // Too large, saturate to Inf.
+	}
+	if (exponent <= 0) {
+		if (exponent < -10) {
+			return sign; // Too small, flush to zero.
+		}
+		// Subnormal half.
+		mantissa |= 0x800000;
+		const uint32_t shift = 14 - exponent;
+		uint32_t half = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1) {
+			half++;
+		}
+		return sign | half;
+	}
+	uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+	if (mantissa & 0x1000) {
+		half++; // Rounding may carry into the exponent, which is still correct.
+	}
+	return half;
+}
+
+static float _half_to_float(uint16_t p_half) {
+	const uint32_t sign = (uint32_t)(p_half & 0x8000) << 16;
+	uint32_t exponent = (p_half >> 10) & 0x1F;
+	uint32_t mantissa = p_half & 0x3FF;
+	uint32_t bits;
+	if (exponent == 0x1F) {
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	} else if (exponent == 0) {
+		if (mantissa == 0) {
+			bits = sign;
+		} else {
+			// Renormalize a subnormal half.
+			exponent = 127 - 15 + 1;
+			while (!(mantissa & 0x400)) {
+				mantissa <<= 1;
+				exponent--;
+			}
+			mantissa &= 0x3FF;
+			bits = sign | (exponent << 23) | (mantissa << 13);
+		}
+	} else {
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	}
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static uint16_t _real_to_fixed(real_t p_value, const Vector2 &p_range) {
+	const real_t t = (p_value - p_range.x) / (p_range.y - p_range.x);
+	// Written so NaN maps to the minimum, as casting it to uint16_t is undefined.
+	if (!(t > 0)) {
+		return 0;
+	}
+	return t < 1 ? (uint16_t)(t * 65535 + (real_t)0.5) : 65535;
+}
+
+static real_t _fixed_to_real(uint16_t p_fixed, const Vector2 &p_range) {
+	return p_range.x + (p_range.y - p_range.x) * ((real_t)p_fixed / 65535);
+}
+
+static uint32_t _quaternion_to_smallest_three(const Quaternion &p_quaternion) {
+	const Quaternion quaternion = p_quaternion.length_squared() > 0 ? p_quaternion.normalized() : Quaternion();
+	const real_t components[4] = { quaternion.x, quaternion.y, quaternion.z, quaternion.w };
+	uint32_t largest = 0;
+	for (uint32_t i = 1; i < 4; i++) {
+		if (Math::abs(components[i]) > Math::abs(components[largest])) {
+			largest = i;
+		}
+	}
+	// q and -q are the same rotation, so flip the sign to make the dropped component positive.
+	const real_t sign = components[largest] < 0 ? -1 : 1;
+	uint32_t packed = largest << 30;
+	uint32_t shift = 20;
+	for (uint32_t i = 0; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		// The remaining components lie within [-1/sqrt(2), 1/sqrt(2)].
+		const real_t t = CLAMP((components[i] * sign * (real_t)Math_SQRT2 + 1) * (real_t)0.5, (real_t)0.0, (real_t)1.0);
+		packed |= (uint32_t)(t * 1023 + (real_t)0.5) << shift;
+		shift -= 10;
+	}
+	return packed;
+}
+
+static Quaternion _smallest_three_to_quaternion(uint32_t p_packed) {
+	const uint32_t largest = p_packed >> 30;
+	real_t components[4];
+	real_t sum = 0;
+	uint32_t shift = 20;
+	for (uint32_t i = 0; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		const real_t value = (((real_t)((p_packed >> shift) & 0x3FF) / 1023) * 2 - 1) * (real_t)Math_SQRT12;
+		components[i] = value;
+		sum += value * value;
+		shift -= 10;
+	}
+	components[largest] = Math::sqrt(MAX((real_t)0.0, 1 - sum));
+	return Quaternion(components[0], components[1], components[2], components[3]);
+}
+
+static void _put_real(SaveloadWriter &r_column, SaveloadEncoder::Encoding p_encoding, const Vector2 &p_range, real_t p_value) {
+	switch (p_encoding) {
+		case SceneSaveloadConfig::ENCODING_HALF: {
+			r_column.put_u16(_float_to_half(p_value));
+		} break;
+		case SceneSaveloadConfig::ENCODING_FIXED_16: {
+			r_column.put_u16(_real_to_fixed(p_value, p_range));
+		} break;
+		default: {
+			r_column.put_real(p_value);
+		} break;
+	}
+}
+
+static real_t _get_real(SaveloadReader &r_column, SaveloadEncoder::Encoding p_encoding, const Vector2 &p_range, uint8_t p_real_size) {
+	switch (p_encoding) {
+		case SceneSaveloadConfig::ENCODING_HALF: {
+			return _half_to_float(r_column.get_u16());
+		}
+		case SceneSaveloadConfig::ENCODING_FIXED_16: {
+			return _fixed_to_real(r_column.get_u16(), p_range);
+		}
+		default: {
+			return r_column.get_real(p_real_size);
+		}
+	}
+}
+
+/****************************
+ * Quantization Helpers End *
+ ****************************/
+
+/*************************************
+ * SaveloadEncoder Definitions Start *
+ *************************************/
+
+SaveloadEncoder::Column SaveloadEncoder::get_column(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::INT:
+			return COLUMN_INT;
+		case Variant::FLOAT:
+			return COLUMN_FLOAT;
+		case Variant::VECTOR2:
+			return COLUMN_VECTOR2;
+		case Variant::VECTOR3:
+			return COLUMN_VECTOR3;
+		case Variant::QUATERNION:
+			return COLUMN_QUATERNION;
+		case Variant::TRANSFORM3D:
+			return COLUMN_TRANSFORM3D;
+		case Variant::COLOR:
+			return COLUMN_COLOR;
+		case Variant::OBJECT:
+			return COLUMN_RESOURCE;
+		default:
+			return COLUMN_VARIANT;
+	}
+}
+
+bool SaveloadEncoder::supports_encoding(Column p_column, Encoding p_encoding) {
+	switch (p_encoding) {
+		case SceneSaveloadConfig::ENCODING_DEFAULT:
+			return true;
+		case SceneSaveloadConfig::ENCODING_HALF:
+			return p_column == COLUMN_FLOAT || p_column == COLUMN_VECTOR2 || p_column == COLUMN_VECTOR3 || p_column == COLUMN_QUATERNION || p_column == COLUMN_TRANSFORM3D;
+		case SceneSaveloadConfig::ENCODING_FIXED_16:
+			return p_column == COLUMN_FLOAT || p_column == COLUMN_VECTOR2 || p_column == COLUMN_VECTOR3;
+		case SceneSaveloadConfig::ENCODING_SMALLEST_THREE:
+			return p_column == COLUMN_QUATERNION;
+		case SceneSaveloadConfig::ENCODING_COLOR_BYTE:
+			return p_column == COLUMN_COLOR;
+		default:
+			return false;
+	}
+}
+
+PackedByteArray SaveloadEncoder::encode_variant(const Variant &p_variant, bool p_allow_objects) {
+#ifdef GDEXTENSION
+	return p_allow_objects ? UtilityFunctions::var_to_bytes_with_objects(p_variant) : UtilityFunctions::var_to_bytes(p_variant);
+#elif
+	PackedByteArray bytes;
+	int len = 0;
+	Error err = ::encode_variant(p_variant, nullptr, len, p_allow_objects);
+	ERR_FAIL_COND_V_MSG(err != OK, bytes, "Unable to encode saveload state.");
+	bytes.resize(len);
+	::encode_variant(p_variant, bytes.ptrw(), len, p_allow_objects);
+	return bytes;
+#endif
+}
+
+bool SaveloadEncoder::is_resource_reference(const Variant &p_value, bool p_allow_objects) {
+	if (p_value.get_type() == Variant::NIL) {
+		return true;
+	}
+	if (p_value.get_type() != Variant::OBJECT) {
+		return false;
+	}
+	Object *object = p_value;
+	const Resource *resource = Object::cast_to<Resource>(object);
+	if (!resource) {
+		return object == nullptr;
+	}
+	// Built-in resources have paths like "res://scene.tscn::1", which cannot be loaded on their own.
+	const String path = resource->get_path();
+	return !path.is_empty() && !path.contains("::") && (p_allow_objects || is_trusted_resource_path(path));
+}
+
+void SaveloadEncoder::get_value_layout(Column p_column, Encoding p_encoding, uint8_t p_real_size, uint32_t &r_value_size, uint32_t &r_component_size) {
+	uint32_t components = 1;
+	switch (p_column) {
+		case COLUMN_VECTOR2: {
+			components = 2;
+		} break;
+		case COLUMN_VECTOR3: {
+			components = 3;
+		} break;
+		case COLUMN_QUATERNION: {
+			components = p_encoding == SceneSaveloadConfig::ENCODING_SMALLEST_THREE ? 1 : 4;
+		} break;
+		case COLUMN_TRANSFORM3D: {
+			components = 12;
+		} break;
+		case COLUMN_COLOR: {
+			components = 4;
+		} break;
+		default: {
+		} break;
+	}
+	switch (p_encoding) {
+		case SceneSaveloadConfig::ENCODING_HALF:
+		case SceneSaveloadConfig::ENCODING_FIXED_16: {
+			r_component_size = sizeof(uint16_t);
+		} break;
+		case SceneSaveloadConfig::ENCODING_SMALLEST_THREE: {
+			r_component_size = sizeof(uint32_t);
+		} break;
+		case SceneSaveloadConfig::ENCODING_COLOR_BYTE: {
+			r_component_size = sizeof(uint8_t);
+		} break;
+		default: {
+			if (p_column == COLUMN_INT || p_column == COLUMN_FLOAT) {
+				r_component_size = sizeof(uint64_t);
+			} else if (p_column == COLUMN_RESOURCE) {
+				r_component_size = sizeof(uint32_t);
+			} else if (p_column == COLUMN_COLOR) {
+				r_component_size = sizeof(float);
+			} else {
+				r_component_size = p_real_size;
+			}
+		} break;
+	}
+	r_value_size = components * r_component_size;
+}
+
+Error SaveloadEncoder::compress(PackedByteArray &r_bytes, int p_mode) {
+	if (p_mode < 0 || p_mode == COMPRESSION_NONE) {
+		return OK;
+	}
+	ERR_FAIL_COND_V_MSG(r_bytes.size() < HEADER_SIZE || r_bytes.ptr()[9] != COMPRESSION_NONE, ERR_INVALID_PARAMETER, "Only uncompressed saveload files can be compressed.");
+#ifdef GDEXTENSION
+	const PackedByteArray payload = r_bytes.slice(HEADER_SIZE).compress(p_mode);
+	ERR_FAIL_COND_V_MSG(payload.is_empty(), ERR_CANT_CREATE, "Unable to compress saveload state.");
+#elif
+	const int payload_size = r_bytes.size() - HEADER_SIZE;
+	PackedByteArray payload;
+	payload.resize(Compression::get_max_compressed_buffer_size(payload_size, (Compression::Mode)p_mode));
+	const int compressed_size = Compression::compress(payload.ptrw(), r_bytes.ptr() + HEADER_SIZE, payload_size, (Compression::Mode)p_mode);
+	ERR_FAIL_COND_V_MSG(compressed_size < 0, ERR_CANT_CREATE, "Unable to compress saveload state.");
+	payload.resize(compressed_size);
+#endif
+	// The payload size in the header stays the uncompressed size, which decompression needs.
+	// The stored bytes get a hash of their own, so validating them needs no decompression.
+	const uint32_t stored_size = payload.size();
+	const uint64_t stored_hash = hash_section(payload.ptr(), stored_size);
+	r_bytes.resize(HEADER_SIZE + stored_size);
+	uint8_t *w = r_bytes.ptrw();
+	w[9] = (uint8_t)p_mode;
+	memcpy(w + STORED_OFFSET, &stored_size, sizeof(stored_size));
+	memcpy(w + STORED_OFFSET + sizeof(stored_size), &stored_hash, sizeof(stored_hash));
+	memcpy(w + HEADER_SIZE, payload.ptr(), stored_size);
+	return OK;
+}
+
+uint64_t SaveloadEncoder::hash_section(const uint8_t *p_data, uint32_t p_size, uint64_t p_hash) {
+	// 64-bit FNV-1a.
+	uint64_t hash = p_hash;
+	for (uint32_t i = 0; i < p_size; i++) {
+		hash = (hash ^ p_data[i]) * 0x100000001B3;
+	}
+	return hash;
+}
+
+bool SaveloadEncoder::has_same_content(const PackedByteArray &p_bytes, const PackedByteArray &p_header, int p_mode) {
+	if (p_bytes.size() < HEADER_SIZE || p_header.size() < HEADER_SIZE) {
+		return false;
+	}
+	const uint8_t mode = p_mode < 0 ? COMPRESSION_NONE : p_mode;
+	const uint8_t *a = p_bytes.ptr();
+	const uint8_t *b = p_header.ptr();
+	// Only the compression byte and the stored size and hash may differ, as p_bytes has not been compressed yet.
+	return b[9] == mode && memcmp(a, b, 9) == 0 && memcmp(a + 10, b + 10, STORED_OFFSET - 10) == 0;
+}
+
+uint32_t SaveloadEncoder::_get_resource_id(const String &p_path) {
+	HashMap<String, uint32_t>::ConstIterator id = resource_ids.find(p_path);
+	if (id) {
+		return id->value;
+	}
+	resource_paths.push_back(p_path);
+	resource_ids.insert(p_path, resource_paths.size() - 1);
+	allocation_count++;
+	return resource_paths.size() - 1;
+}
+
+uint32_t SaveloadEncoder::_get_spawn_arg_id(const Variant &p_spawn_args) {
+	HashMap<Variant, uint32_t, VariantHasher, VariantComparator>::ConstIterator id = spawn_arg_ids.find(p_spawn_args);
+	if (id) {
+		return id->value;
+	}
+	// A new value gets the next ID, which tells the decoder to take it from the variants.
+	const uint32_t new_id = spawn_arg_ids.size();
+	spawn_arg_ids.insert(p_spawn_args, new_id);
+	allocation_count++;
+	variants.push_back(p_spawn_args);
+	return new_id;
+}
+
+SaveloadEncoder::PropertyFormat SaveloadEncoder::_get_property_format(const Ref<SceneSaveloadConfig> &p_config, const NodePath &p_property) {
+	if (p_config.is_null()) {
+		return PropertyFormat();
+	}
+	const uint64_t config_id = p_config->get_instance_id();
+	if (!config_formats.has(config_id)) {
+		HashMap<NodePath, PropertyFormat> formats;
+		const TypedArray<NodePath> properties = p_config->get_properties();
+		for (int i = 0; i < properties.size(); i++) {
+			PropertyFormat format;
+			format.type = p_config->property_get_type(properties[i]);
+			format.encoding = p_config->property_get_encoding(properties[i]);
+			format.range = p_config->property_get_encoding_range(properties[i]);
+			formats.insert(properties[i], format);
+		}
+		config_formats.insert(config_id, formats);
+		allocation_count += 1 + formats.size();
+	}
+	const HashMap<NodePath, PropertyFormat> &formats = config_formats[config_id];
+	const HashMap<NodePath, PropertyFormat>::ConstIterator format = formats.find(p_property);
+	return format ? format->value : PropertyFormat();
+}
+
+uint32_t SaveloadEncoder::_get_file_path_id(uint32_t p_path_id) {
+	ERR_FAIL_COND_V_MSG(!SaveloadPathTable::get_singleton()->is_valid(p_path_id), 0, "Saving a node that is not inside the tree.");
+	if (p_path_id >= file_path_ids.size()) {
+		// Path IDs are dense, so this only grows as new paths are interned.
+		const uint32_t old_size = file_path_ids.size();
+		file_path_ids.resize(SaveloadPathTable::get_singleton()->size());
+		for (uint32_t i = old_size; i < file_path_ids.size(); i++) {
+			file_path_ids[i] = SaveloadPathTable::INVALID_ID;
+		}
+		allocation_count++;
+	}
+	uint32_t &file_path_id = file_path_ids[p_path_id];
+	if (file_path_id == SaveloadPathTable::INVALID_ID) {
+		file_path_id = file_paths.size();
+		file_paths.push_back(p_path_id);
+	}
+	return file_path_id;
+}
+
+void SaveloadEncoder::_put_value(Column p_column, Encoding p_encoding, const Vector2 &p_range, const Variant &p_value) {
+	SaveloadWriter &column = columns[p_column][p_encoding];
+	switch (p_column) {
+		case COLUMN_INT: {
+			column.put_u64((int64_t)p_value);
+		} break;
+		case COLUMN_FLOAT: {
+			if (p_encoding == SceneSaveloadConfig::ENCODING_DEFAULT) {
+				column.put_double((double)p_value);
+			} else {
+				_put_real(column, p_encoding, p_range, (real_t)(double)p_value);
+			}
+		} break;
+		case COLUMN_VECTOR2: {
+			const Vector2 vector = p_value;
+			_put_real(column, p_encoding, p_range, vector.x);
+			_put_real(column, p_encoding, p_range, vector.y);
+		} break;
+		case COLUMN_VECTOR3: {
+			const Vector3 vector = p_value;
+			_put_real(column, p_encoding, p_range, vector.x);
+			_put_real(column, p_encoding, p_range, vector.y);
+			_put_real(column, p_encoding, p_range, vector.z);
+		} break;
+		case COLUMN_QUATERNION: {
+			const Quaternion quaternion = p_value;
+			if (p_encoding == SceneSaveloadConfig::ENCODING_SMALLEST_THREE) {
+				column.put_u32(_quaternion_to_smallest_three(quaternion));
+				break;
+			}
+			_put_real(column, p_encoding, p_range, quaternion.x);
+			_put_real(column, p_encoding, p_range, quaternion.y);
+			_put_real(column, p_encoding, p_range, quaternion.z);
+			_put_real(column, p_encoding, p_range, quaternion.w);
+		} break;
+		case COLUMN_TRANSFORM3D: {
+			const Transform3D transform = p_value;
+			for (int i = 0; i < 3; i++) {
+				_put_real(column, p_encoding, p_range, transform.basis.rows[i].x);
+				_put_real(column, p_encoding, p_range, transform.basis.rows[i].y);
+				_put_real(column, p_encoding, p_range, transform.basis.rows[i].z);
+			}
+			_put_real(column, p_encoding, p_range, transform.origin.x);
+			_put_real(column, p_encoding, p_range, transform.origin.y);
+			_put_real(column, p_encoding, p_range, transform.origin.z);
+		} break;
+		case COLUMN_COLOR: {
+			const Color color = p_value;
+			if (p_encoding == SceneSaveloadConfig::ENCODING_COLOR_BYTE) {
+				column.put_u8((uint8_t)(CLAMP(color.r, 0.0f, 1.0f) * 255 + 0.5f));
+				column.put_u8((uint8_t)(CLAMP(color.g, 0.0f, 1.0f) * 255 + 0.5f));
+				column.put_u8((uint8_t)(CLAMP(color.b, 0.0f, 1.0f) * 255 + 0.5f));
+				column.put_u8((uint8_t)(CLAMP(color.a, 0.0f, 1.0f) * 255 + 0.5f));
+				break;
+			}
+			column.put_float(color.r);
+			column.put_float(color.g);
+			column.put_float(color.b);
+			column.put_float(color.a);
+		} break;
+		case COLUMN_RESOURCE: {
+			Object *object = p_value;
+			const Resource *resource = Object::cast_to<Resource>(object);
+			column.put_u32(resource ? _get_resource_id(resource->get_path()) + 1 : 0);
+		} break;
+		default: {
+			variants.push_back(p_value);
+		} break;
+	}
+}
+
+Error SaveloadEncoder::encode(const SceneSaveload::SaveloadState &p_saveload_state, PackedByteArray &r_bytes) {
+	for (int i = 0; i < COLUMN_MAX; i++) {
+		for (int j = 0; j < SceneSaveloadConfig::ENCODING_MAX; j++) {
+			columns[i][j].clear();
+		}
+	}
+	variants.clear();
+	tables.clear();
+	config_formats.clear();
+	// Only the entries of the last save are set, so only those need resetting.
+	for (const uint32_t path_id : file_paths) {
+		file_path_ids[path_id] = SaveloadPathTable::INVALID_ID;
+	}
+	file_paths.clear();
+	allocation_count = 0;
+	const uint32_t transform_capacity = transform_buffer.size();
+
+	spawn_arg_ids.clear();
+	resource_ids.clear();
+	resource_paths.clear();
+
+	tables.put_u32(p_saveload_state.spawner_states.size());
+	for (const KeyValue<uint32_t, SaveloadSpawner::SpawnerState> &spawner_state : p_saveload_state.spawner_states) {
+		tables.put_u32(_get_file_path_id(spawner_state.key));
+		tables.put_u32(spawner_state.value.size());
+		for (const SaveloadSpawner::SpawnInfo &spawn_info : spawner_state.value.spawn_infos) {
+			tables.put_u32(_get_file_path_id(spawn_info.path_id));
+			tables.put_u32((uint32_t)spawn_info.scene_index);
+			tables.put_u32(_get_spawn_arg_id(spawn_info.spawn_args));
+		}
+	}
+
+	tables.put_u32(p_saveload_state.syncher_groups.size());
+	for (const SceneSaveload::SyncherGroup &group : p_saveload_state.syncher_groups) {
+		const uint32_t instance_count = group.synchers.size();
+		tables.put_u32(group.properties.size());
+		tables.put_u32(instance_count);
+		tables.put_u64(group.fingerprint);
+		for (const uint32_t syncher_path_id : group.synchers) {
+			tables.put_u32(_get_file_path_id(syncher_path_id));
+		}
+		for (uint32_t i = 0; i < group.properties.size(); i++) {
+			const LocalVector<Variant> &values = group.columns[i];
+			bool has_missing = false;
+			for (uint32_t j = 0; j < instance_count && !has_missing; j++) {
+				has_missing = group.is_missing(i, j);
+			}
+			// Prefer the type recorded in the config and fall back to the type of the first set value.
+			// A property whose values do not all share that type is stored untyped.
+			const PropertyFormat format = _get_property_format(group.config, SaveloadPathTable::get_singleton()->get_path(group.properties[i]));
+			Variant::Type type = format.type;
+			for (uint32_t j = 0; j < instance_count && type == Variant::NIL; j++) {
+				if (!group.is_missing(i, j)) {
+					type = values[j].get_type();
+				}
+			}
+			Column column = get_column(type);
+			for (uint32_t j = 0; j < instance_count && column != COLUMN_VARIANT; j++) {
+				if (group.is_missing(i, j)) {
+					continue;
+				}
+				// Resource columns also take nulls, but any other object has to be stored untyped.
+				if (column == COLUMN_RESOURCE ? !is_resource_reference(values[j], allow_objects) : values[j].get_type() != type) {
+					column = COLUMN_VARIANT;
+				}
+			}
+			Encoding encoding = supports_encoding(column, format.encoding) ? format.encoding : SceneSaveloadConfig::ENCODING_DEFAULT;
+			if (encoding == SceneSaveloadConfig::ENCODING_FIXED_16 && !SceneSaveloadConfig::is_valid_encoding_range(Vector2((float)format.range.x, (float)format.range.y))) {
+				// The range is stored as floats, so it has to stay valid at float precision.
+				encoding = SceneSaveloadConfig::ENCODING_DEFAULT;
+			}
+			tables.put_u32(_get_file_path_id(group.properties[i]));
+			tables.put_u8(column);
+			tables.put_u8(encoding);
+			if (encoding == SceneSaveloadConfig::ENCODING_FIXED_16) {
+				tables.put_float(format.range.x);
+				tables.put_float(format.range.y);
+			}
+			tables.put_u8(has_missing);
+			if (has_missing) {
+				for (uint32_t j = 0; j < instance_count; j += 8) {
+					uint8_t bits = 0;
+					for (uint32_t k = j; k < MIN(j + 8, instance_count); k++) {
+						bits |= (uint8_t)group.is_missing(i, k) << (k - j);
+					}
+					tables.put_u8(bits);
+				}
+			}
+			for (uint32_t j = 0; j < instance_count; j++) {
+				if (!group.is_missing(i, j)) {
+					_put_value(column, encoding, format.range, values[j]);
+				}
+			}
+		}
+	}
+
+	const PackedByteArray variant_bytes = encode_variant(variants, allow_objects);
+
+	path_table.clear();
+	path_table.put_u32(file_paths.size());
+	for (const uint32_t path_id : file_paths) {
+		path_table.put_string(SaveloadPathTable::get_singleton()->get_path(path_id));
+	}
+	path_table.put_u32(resource_paths.size());
+	for (const String &resource_path : resource_paths) {
+		path_table.put_string(resource_path);
+	}
+
+	column_directory.clear();
+	uint32_t column_count = 0;
+	uint32_t column_bytes = 0;
+	for (int i = COLUMN_VARIANT + 1; i < COLUMN_MAX; i++) {
+		for (int j = 0; j < SceneSaveloadConfig::ENCODING_MAX; j++) {
+			if (columns[i][j].size()) {
+				column_count++;
+				column_bytes += columns[i][j].size();
+			}
+		}
+	}
+	column_directory.put_u32(column_count);
+
+	uint32_t section_sizes[SECTION_MAX];
+	section_sizes[SECTION_COLUMNS] = column_directory.size() + column_count * (3 + sizeof(uint32_t)) + column_bytes;
+	section_sizes[SECTION_VARIANTS] = sizeof(uint32_t) + variant_bytes.size();
+	section_sizes[SECTION_PATHS] = path_table.size();
+	section_sizes[SECTION_TABLES] = tables.size();
+	uint32_t payload_size = 0;
+	for (int i = 0; i < SECTION_MAX; i++) {
+		payload_size += section_sizes[i];
+	}
+	header.clear();
+	header.put_u32(FORMAT_MAGIC);
+	header.put_u32(FORMAT_VERSION);
+	header.put_u8(sizeof(real_t));
+	header.put_u8(COMPRESSION_NONE);
+	header.put_u32(payload_size);
+	for (int i = 0; i < SECTION_MAX; i++) {
+		header.put_u32(section_sizes[i]);
+		header.put_u64(0); // Hash, filled in once the section is written.
+	}
+	// The stored bytes are the payload itself until compress() is called, and need no hash of their own.
+	header.put_u32(payload_size);
+	header.put_u64(0);
+	DEV_ASSERT(header.size() == HEADER_SIZE);
+
+	r_bytes.resize(HEADER_SIZE + payload_size);
+	uint8_t *w = r_bytes.ptrw();
+	uint32_t offset = 0;
+	const auto put = [&](const void *p_data, uint32_t p_size) {
+		memcpy(w + offset, p_data, p_size);
+		offset += p_size;
+	};
+	put(header.ptr(), header.size());
+	put(column_directory.ptr(), column_directory.size());
+	for (uint8_t i = COLUMN_VARIANT + 1; i < COLUMN_MAX; i++) {
+		for (uint8_t j = 0; j < SceneSaveloadConfig::ENCODING_MAX; j++) {
+			const uint32_t column_size = columns[i][j].size();
+			if (!column_size) {
+				continue;
+			}
+			// Neighbouring instances of a float property tend to be close, so XORing each value
+			// with the previous one leaves mostly zero mantissa and exponent bytes, and shuffling
+			// gathers those into long runs for the compressor. Integer columns are left as they are.
+			uint32_t value_size;
+			uint32_t component_size;
+			get_value_layout((Column)i, (Encoding)j, sizeof(real_t), value_size, component_size);
+			const uint8_t transform = i != COLUMN_INT && i != COLUMN_RESOURCE && column_size >= value_size * 2 ? TRANSFORM_XOR_SHUFFLE : TRANSFORM_NONE;
+			put(&i, 1);
+			put(&j, 1);
+			put(&transform, 1);
+			put(&column_size, sizeof(column_size));
+			if (transform == TRANSFORM_XOR_SHUFFLE) {
+				if (column_size > transform_buffer.size()) {
+					transform_buffer.resize(column_size);
+				}
+				SaveloadSimd::xor_neighbours(columns[i][j].ptr(), transform_buffer.ptr(), column_size, value_size);
+				SaveloadSimd::shuffle(transform_buffer.ptr(), w + offset, column_size, component_size);
+				offset += column_size;
+			} else {
+				put(columns[i][j].ptr(), column_size);
+			}
+		}
+	}
+	const uint32_t variant_size = variant_bytes.size();
+	put(&variant_size, sizeof(variant_size));
+	put(variant_bytes.ptr(), variant_size);
+	put(path_table.ptr(), path_table.size());
+	put(tables.ptr(), tables.size());
+	DEV_ASSERT(offset == HEADER_SIZE + payload_size);
+
+	uint32_t section_offset = HEADER_SIZE;
+	for (int i = 0; i < SECTION_MAX; i++) {
+		const uint64_t hash = hash_section(w + section_offset, section_sizes[i]);
+		memcpy(w + SECTION_TABLE_OFFSET + i * SECTION_ENTRY_SIZE + sizeof(uint32_t), &hash, sizeof(hash));
+		section_offset += section_sizes[i];
+	}
+
+	if (transform_buffer.size() > transform_capacity) {
+		allocation_count++;
+	}
+	allocation_count += tables.get_grow_count() + path_table.get_grow_count() + column_directory.get_grow_count() + header.get_grow_count();
+	for (int i = 0; i < COLUMN_MAX; i++) {
+		for (int j = 0; j < SceneSaveloadConfig::ENCODING_MAX; j++) {
+			allocation_count += columns[i][j].get_grow_count();
+		}
+	}
+	return OK;
+}
+
+/***********************************
+ * SaveloadEncoder Definitions End *
+ ***********************************/
+
+/*************************************
+ * SaveloadDecoder Definitions Start *
+ *************************************/
+
+bool SaveloadDecoder::has_magic(const PackedByteArray &p_bytes) {
+	if (p_bytes.size() < (int64_t)sizeof(uint32_t)) {
+		return false;
+	}
+	uint32_t magic;
+	memcpy(&magic, p_bytes.ptr(), sizeof(magic));
+	return magic == SaveloadEncoder::FORMAT_MAGIC;
+}
+
+Variant SaveloadDecoder::decode_variant(const PackedByteArray &p_bytes, bool p_allow_objects) {
+#ifdef GDEXTENSION
+	return p_allow_objects ? UtilityFunctions::bytes_to_var_with_objects(p_bytes) : UtilityFunctions::bytes_to_var(p_bytes);
+#elif
+	Variant variant;
+	Error err = ::decode_variant(variant, p_bytes.ptr(), p_bytes.size(), nullptr, p_allow_objects);
+	ERR_FAIL_COND_V_MSG(err != OK, Variant(), "Unable to decode saveload state.");
+	return variant;
+#endif
+}
+
+Error SaveloadDecoder::decompress(PackedByteArray &r_bytes) {
+	ERR_FAIL_COND_V_MSG(r_bytes.size() < SaveloadEncoder::SECTION_TABLE_OFFSET, ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	const uint8_t mode = r_bytes.ptr()[9];
+	if (mode == SaveloadEncoder::COMPRESSION_NONE) {
+		return OK;
+	}
+	uint32_t version;
+	memcpy(&version, r_bytes.ptr() + 4, sizeof(version));
+	ERR_FAIL_COND_V_MSG(!SaveloadEncoder::is_supported_version(version), ERR_FILE_UNRECOGNIZED, vformat("Saveload file version %d is not supported.", version));
+	const uint32_t header_size = SaveloadEncoder::get_header_size(version);
+	ERR_FAIL_COND_V_MSG(r_bytes.size() < header_size, ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	uint32_t payload_size;
+	memcpy(&payload_size, r_bytes.ptr() + 10, sizeof(payload_size));
+	// The size comes from the file, so it is checked before anything is allocated for it.
+	const uint64_t stored_size = r_bytes.size() - header_size;
+	ERR_FAIL_COND_V_MSG(payload_size > SaveloadEncoder::MAX_PAYLOAD_SIZE || payload_size > stored_size * SaveloadEncoder::MAX_COMPRESSION_RATIO, ERR_FILE_CORRUPT, "Saveload file has an invalid payload size.");
+#ifdef GDEXTENSION
+	const PackedByteArray payload = r_bytes.slice(header_size).decompress(payload_size, mode);
+	ERR_FAIL_COND_V_MSG((uint32_t)payload.size() != payload_size, ERR_FILE_CORRUPT, "Unable to decompress saveload file.");
+#elif
+	PackedByteArray payload;
+	payload.resize(payload_size);
+	const int decompressed_size = Compression::decompress(payload.ptrw(), payload_size, r_bytes.ptr() + header_size, (int)stored_size, (Compression::Mode)mode);
+	ERR_FAIL_COND_V_MSG(decompressed_size != (int)payload_size, ERR_FILE_CORRUPT, "Unable to decompress saveload file.");
+#endif
+	r_bytes.resize(header_size + payload_size);
+	uint8_t *w = r_bytes.ptrw();
+	w[9] = SaveloadEncoder::COMPRESSION_NONE;
+	if (version >= SaveloadEncoder::VERSION_STORED_HASH) {
+		// As encode() leaves them for an uncompressed file.
+		const uint64_t stored_hash = 0;
+		memcpy(w + SaveloadEncoder::STORED_OFFSET, &payload_size, sizeof(payload_size));
+		memcpy(w + SaveloadEncoder::STORED_OFFSET + sizeof(payload_size), &stored_hash, sizeof(stored_hash));
+	}
+	memcpy(w + header_size, payload.ptr(), payload_size);
+	return OK;
+}
+
+Error SaveloadDecoder::_validate_header(const PackedByteArray &p_header, uint64_t p_file_size, HeaderInfo &r_info) {
+	ERR_FAIL_COND_V_MSG(p_header.size() < SaveloadEncoder::SECTION_TABLE_OFFSET, ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	SaveloadReader reader(p_header.ptr(), p_header.size());
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != SaveloadEncoder::FORMAT_MAGIC, ERR_FILE_UNRECOGNIZED, "Not a saveload file.");
+	r_info.version = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(!SaveloadEncoder::is_supported_version(r_info.version), ERR_FILE_UNRECOGNIZED, vformat("Saveload file version %d is not between the supported versions %d and %d.", r_info.version, SaveloadEncoder::MIN_FORMAT_VERSION, SaveloadEncoder::FORMAT_VERSION));
+	r_info.header_size = SaveloadEncoder::get_header_size(r_info.version);
+	ERR_FAIL_COND_V_MSG((uint32_t)p_header.size() < r_info.header_size, ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	const uint8_t real_size = reader.get_u8();
+	ERR_FAIL_COND_V_MSG(real_size != sizeof(float) && real_size != sizeof(double), ERR_FILE_CORRUPT, "Saveload file has an invalid real size.");
+	r_info.compression = reader.get_u8();
+	const uint32_t payload_size = reader.get_u32();
+	if (r_info.has_section_table()) {
+		uint64_t section_total = 0;
+		for (int i = 0; i < SaveloadEncoder::SECTION_MAX; i++) {
+			r_info.section_sizes[i] = reader.get_u32();
+			r_info.section_hashes[i] = reader.get_u64();
+			section_total += r_info.section_sizes[i];
+		}
+		ERR_FAIL_COND_V_MSG(section_total != payload_size, ERR_FILE_CORRUPT, "Saveload file has an invalid payload size.");
+	}
+	if (r_info.compression == SaveloadEncoder::COMPRESSION_NONE) {
+		ERR_FAIL_COND_V_MSG(p_file_size != r_info.header_size + (uint64_t)payload_size, ERR_FILE_CORRUPT, "Saveload file size does not match its header.");
+	} else if (r_info.version >= SaveloadEncoder::VERSION_STORED_HASH) {
+		const uint32_t stored_size = reader.get_u32();
+		r_info.stored_hash = reader.get_u64();
+		ERR_FAIL_COND_V_MSG(stored_size == 0 || p_file_size != r_info.header_size + (uint64_t)stored_size, ERR_FILE_CORRUPT, "Saveload file size does not match its header.");
+	} else {
+		ERR_FAIL_COND_V_MSG(p_file_size <= r_info.header_size, ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	}
+	return OK;
+}
+
+Error SaveloadDecoder::_validate_bytes(PackedByteArray &r_bytes) {
+	HeaderInfo info;
+	Error err = _validate_header(r_bytes, r_bytes.size(), info);
+	if (err != OK || !info.has_section_table()) {
+		return err;
+	}
+	if (info.has_stored_hash()) {
+		const uint64_t hash = SaveloadEncoder::hash_section(r_bytes.ptr() + info.header_size, r_bytes.size() - info.header_size);
+		ERR_FAIL_COND_V_MSG(hash != info.stored_hash, ERR_FILE_CORRUPT, "Saveload file payload does not match its hash.");
+		return OK;
+	}
+	err = decompress(r_bytes);
+	if (err != OK) {
+		return err;
+	}
+	uint32_t offset = info.header_size;
+	for (int i = 0; i < SaveloadEncoder::SECTION_MAX; i++) {
+		ERR_FAIL_COND_V_MSG(SaveloadEncoder::hash_section(r_bytes.ptr() + offset, info.section_sizes[i]) != info.section_hashes[i], ERR_FILE_CORRUPT, vformat("Saveload file section %d does not match its hash.", i));
+		offset += info.section_sizes[i];
+	}
+	return OK;
+}
+
+// Hashes the next p_size bytes of p_file a block at a time, so a large file is never held in memory.
+static Error _hash_file_range(const Ref<FileAccess> &p_file, uint32_t p_size, uint32_t p_block_size, uint64_t &r_hash) {
+	r_hash = SaveloadEncoder::hash_section(nullptr, 0);
+	for (uint32_t remaining = p_size; remaining > 0;) {
+		const uint32_t size = MIN(remaining, p_block_size);
+		const PackedByteArray block = p_file->get_buffer(size);
+		ERR_FAIL_COND_V_MSG((uint32_t)block.size() != size, ERR_FILE_CORRUPT, "Saveload file is truncated.");
+		r_hash = SaveloadEncoder::hash_section(block.ptr(), size, r_hash);
+		remaining -= size;
+	}
+	return OK;
+}
+
+Error SaveloadDecoder::validate(const String &p_path, const String &p_store_directory, const PackedByteArray &p_encryption_key) {
+	Error err;
+#ifdef GDEXTENSION
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
+	err = FileAccess::get_open_error();
+#elif
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ, &err);
+#endif
+	if (err != OK) {
+		return err;
+	}
+	const uint64_t file_size = file->get_length();
+	PackedByteArray header = file->get_buffer(MIN(file_size, MAX((uint64_t)SaveloadEncoder::HEADER_SIZE, (uint64_t)SaveloadCipher::HEADER_SIZE)));
+	if (SaveloadCipher::is_encrypted(header)) {
+		if (p_encryption_key.is_empty()) {
+			// Without the key only the layout can be checked.
+			return SaveloadCipher::check_size(header, file_size);
+		}
+		file->seek(0);
+		const PackedByteArray encrypted = file->get_buffer(file_size);
+		SaveloadCipher cipher;
+		err = cipher.begin_decrypt(encrypted, p_encryption_key);
+		if (err != OK) {
+			return err;
+		}
+		cipher.process_all();
+		PackedByteArray bytes;
+		err = cipher.finish(bytes);
+		return err != OK ? err : _validate_bytes(bytes);
+	}
+	if (SaveloadChunkStore::is_manifest(header)) {
+		// Restoring checks each chunk against its hash, then the result is checked like any other file.
+		file->seek(0);
+		PackedByteArray bytes;
+		err = SaveloadChunkStore::restore(file->get_buffer(file_size), p_store_directory, bytes);
+		return err != OK ? err : _validate_bytes(bytes);
+	}
+	if (!has_magic(header)) {
+		// Files written before the binary format hold a single length-prefixed store_var value and carry no hashes.
+		ERR_FAIL_COND_V_MSG(file_size < sizeof(uint32_t), ERR_FILE_CORRUPT, "Saveload file is truncated.");
+		uint32_t length;
+		memcpy(&length, header.ptr(), sizeof(length));
+		ERR_FAIL_COND_V_MSG(file_size != sizeof(uint32_t) + (uint64_t)length, ERR_FILE_CORRUPT, "Saveload file size does not match its length.");
+		return OK;
+	}
+	HeaderInfo info;
+	err = _validate_header(header, file_size, info);
+	if (err != OK || !info.has_section_table()) {
+		// Files from before the section table only have their size checked.
+		return err;
+	}
+	file->seek(info.header_size);
+	if (info.has_stored_hash()) {
+		// Compressed files are checked as stored, without inflating them.
+		uint64_t hash;
+		err = _hash_file_range(file, file_size - info.header_size, VALIDATE_BLOCK_SIZE, hash);
+		if (err != OK) {
+			return err;
+		}
+		ERR_FAIL_COND_V_MSG(hash != info.stored_hash, ERR_FILE_CORRUPT, "Saveload file payload does not match its hash.");
+		return OK;
+	}
+	if (info.compression != SaveloadEncoder::COMPRESSION_NONE) {
+		// Older compressed files only hash their uncompressed payload, so they have to be inflated first.
+		file->seek(0);
+		PackedByteArray bytes = file->get_buffer(file_size);
+		return _validate_bytes(bytes);
+	}
+	for (int i = 0; i < SaveloadEncoder::SECTION_MAX; i++) {
+		uint64_t hash;
+		err = _hash_file_range(file, info.section_sizes[i], VALIDATE_BLOCK_SIZE, hash);
+		if (err != OK) {
+			return err;
+		}
+		ERR_FAIL_COND_V_MSG(hash != info.section_hashes[i], ERR_FILE_CORRUPT, vformat("Saveload file section %d does not match its hash.", i));
+	}
+	return OK;
+}
+
+uint32_t SaveloadDecoder::_get_path_id(uint32_t p_file_path_id) {
+	if (p_file_path_id >= path_count) {
+		path_overrun = true;
+		return SaveloadPathTable::INVALID_ID;
+	}
+	return path_ids[p_file_path_id];
+}
+
+uint32_t SaveloadDecoder::_read_path_id(SaveloadReader &r_reader) {
+	if (version < SaveloadEncoder::VERSION_PATH_TABLE) {
+		return SaveloadPathTable::get_singleton()->intern(NodePath(r_reader.get_string()));
+	}
+	return _get_path_id(r_reader.get_u32());
+}
+
+Variant SaveloadDecoder::_get_variant() {
+	if (variant_index >= (uint32_t)variants.size()) {
+		corrupt = true;
+		return Variant();
+	}
+	return variants[variant_index++];
+}
+
+Variant SaveloadDecoder::_get_value(SaveloadEncoder::Column p_column, SaveloadEncoder::Encoding p_encoding, const Vector2 &p_range) {
+	SaveloadReader &column = columns[p_column][p_encoding];
+	switch (p_column) {
+		case SaveloadEncoder::COLUMN_INT: {
+			return (int64_t)column.get_u64();
+		}
+		case SaveloadEncoder::COLUMN_FLOAT: {
+			if (p_encoding == SceneSaveloadConfig::ENCODING_DEFAULT) {
+				return column.get_double();
+			}
+			return _get_real(column, p_encoding, p_range, real_size);
+		}
+		case SaveloadEncoder::COLUMN_VECTOR2: {
+			Vector2 vector;
+			vector.x = _get_real(column, p_encoding, p_range, real_size);
+			vector.y = _get_real(column, p_encoding, p_range, real_size);
+			return vector;
+		}
+		case SaveloadEncoder::COLUMN_VECTOR3: {
+			Vector3 vector;
+			vector.x = _get_real(column, p_encoding, p_range, real_size);
+			vector.y = _get_real(column, p_encoding, p_range, real_size);
+			vector.z = _get_real(column, p_encoding, p_range, real_size);
+			return vector;
+		}
+		case SaveloadEncoder::COLUMN_QUATERNION: {
+			if (p_encoding == SceneSaveloadConfig::ENCODING_SMALLEST_THREE) {
+				return _smallest_three_to_quaternion(column.get_u32());
+			}
+			Quaternion quaternion;
+			quaternion.x = _get_real(column, p_encoding, p_range, real_size);
+			quaternion.y = _get_real(column, p_encoding, p_range, real_size);
+			quaternion.z = _get_real(column, p_encoding, p_range, real_size);
+			quaternion.w = _get_real(column, p_encoding, p_range, real_size);
+			return quaternion;
+		}
+		case SaveloadEncoder::COLUMN_TRANSFORM3D: {
+			Transform3D transform;
+			for (int i = 0; i < 3; i++) {
+				transform.basis.rows[i].x = _get_real(column, p_encoding, p_range, real_size);
+				transform.basis.rows[i].y = _get_real(column, p_encoding, p_range, real_size);
+				transform.basis.rows[i].z = _get_real(column, p_encoding, p_range, real_size);
+			}
+			transform.origin.x = _get_real(column, p_encoding, p_range, real_size);
+			transform.origin.y = _get_real(column, p_encoding, p_range, real_size);
+			transform.origin.z = _get_real(column, p_encoding, p_range, real_size);
+			return transform;
+		}
+		case SaveloadEncoder::COLUMN_COLOR: {
+			Color color;
+			if (p_encoding == SceneSaveloadConfig::ENCODING_COLOR_BYTE) {
+				color.r = column.get_u8() / 255.0f;
+				color.g = column.get_u8() / 255.0f;
+				color.b = column.get_u8() / 255.0f;
+				color.a = column.get_u8() / 255.0f;
+				return color;
+			}
+			color.r = column.get_float();
+			color.g = column.get_float();
+			color.b = column.get_float();
+			color.a = column.get_float();
+			return color;
+		}
+		case SaveloadEncoder::COLUMN_RESOURCE: {
+			const uint32_t id = column.get_u32();
+			if (id > resources.size()) {
+				corrupt = true;
+				return Variant();
+			}
+			return id ? resources[id - 1] : Variant();
+		}
+		default: {
+			return _get_variant();
+		}
+	}
+}
+
+void SaveloadDecoder::_load_resources(const LocalVector<String> &p_paths) {
+	resources.resize(p_paths.size());
+	// Paths outside the project stay null unless objects are allowed, whatever the file asks for.
+	LocalVector<bool> trusted_resources;
+	trusted_resources.resize(p_paths.size());
+	for (uint32_t i = 0; i < p_paths.size(); i++) {
+		trusted_resources[i] = allow_objects || SaveloadEncoder::is_trusted_resource_path(p_paths[i]);
+		if (!trusted_resources[i]) {
+			ERR_PRINT(vformat("Not loading resource %s referenced by saveload file, as only res:// paths are loaded without allow_objects.", p_paths[i]));
+		}
+	}
+#ifdef GDEXTENSION
+	ResourceLoader *loader = ResourceLoader::get_singleton();
+#endif
+	if (threaded_resources) {
+		for (uint32_t i = 0; i < p_paths.size(); i++) {
+			if (!trusted_resources[i]) {
+				continue;
+			}
+			const String &path = p_paths[i];
+#ifdef GDEXTENSION
+			loader->load_threaded_request(path);
+#elif
+			ResourceLoader::load_threaded_request(path);
+#endif
+		}
+	}
+	for (uint32_t i = 0; i < p_paths.size(); i++) {
+		if (!trusted_resources[i]) {
+			continue;
+		}
+#ifdef GDEXTENSION
+		resources[i] = threaded_resources ? loader->load_threaded_get(p_paths[i]) : loader->load(p_paths[i]);
+#elif
+		resources[i] = threaded_resources ? ResourceLoader::load_threaded_get(p_paths[i]) : ResourceLoader::load(p_paths[i]);
+#endif
+		ERR_CONTINUE_MSG(resources[i].get_type() == Variant::NIL, vformat("Could not load resource %s referenced by saveload file.", p_paths[i]));
+	}
+}
+
+Error SaveloadDecoder::decode(const PackedByteArray &p_bytes, SceneSaveload::SaveloadState &r_saveload_state) {
+	SaveloadReader reader(p_bytes.ptr(), p_bytes.size());
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != SaveloadEncoder::FORMAT_MAGIC, ERR_FILE_UNRECOGNIZED, "Not a saveload file.");
+	version = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(!SaveloadEncoder::is_supported_version(version), ERR_FILE_UNRECOGNIZED, vformat("Saveload file version %d is not between the supported versions %d and %d.", version, SaveloadEncoder::MIN_FORMAT_VERSION, SaveloadEncoder::FORMAT_VERSION));
+	real_size = reader.get_u8();
+	ERR_FAIL_COND_V_MSG(real_size != sizeof(float) && real_size != sizeof(double), ERR_FILE_CORRUPT, "Saveload file has an invalid real size.");
+	ERR_FAIL_COND_V_MSG(reader.get_u8() != SaveloadEncoder::COMPRESSION_NONE, ERR_INVALID_PARAMETER, "Saveload file must be decompressed before decoding.");
+	const uint32_t payload_size = reader.get_u32();
+	uint64_t section_total = payload_size;
+	if (version >= SaveloadEncoder::VERSION_SECTION_TABLE) {
+		section_total = 0;
+		for (int i = 0; i < SaveloadEncoder::SECTION_MAX; i++) {
+			section_total += reader.get_u32();
+			reader.get_u64();
+		}
+	}
+	ERR_FAIL_COND_V_MSG(payload_size != reader.get_remaining() || section_total != payload_size, ERR_FILE_CORRUPT, "Saveload file has an invalid payload size.");
+
+	const uint32_t column_count = reader.get_u32();
+	for (uint32_t i = 0; i < column_count && !reader.has_overrun(); i++) {
+		const uint8_t column = reader.get_u8();
+		const uint8_t encoding = reader.get_u8();
+		const uint8_t transform = reader.get_u8();
+		const uint32_t column_size = reader.get_u32();
+		ERR_FAIL_COND_V_MSG(column >= SaveloadEncoder::COLUMN_MAX || encoding >= SceneSaveloadConfig::ENCODING_MAX || transform >= SaveloadEncoder::TRANSFORM_MAX, ERR_FILE_CORRUPT, "Saveload file has an invalid column.");
+		const uint8_t *span = reader.get_span(column_size);
+		if (!span || transform == SaveloadEncoder::TRANSFORM_NONE) {
+			columns[column][encoding] = SaveloadReader(span, column_size);
+			continue;
+		}
+		uint32_t value_size;
+		uint32_t component_size;
+		SaveloadEncoder::get_value_layout((SaveloadEncoder::Column)column, (SaveloadEncoder::Encoding)encoding, real_size, value_size, component_size);
+		uint8_t *data = arena->alloc_array<uint8_t>(column_size);
+		ERR_FAIL_NULL_V(data, ERR_OUT_OF_MEMORY);
+		SaveloadSimd::unshuffle(span, data, column_size, component_size);
+		SaveloadSimd::unxor_neighbours(data, column_size, value_size);
+		columns[column][encoding] = SaveloadReader(data, column_size);
+	}
+	const uint32_t variant_size = reader.get_u32();
+	const uint32_t variant_offset = reader.get_position();
+	reader.get_span(variant_size);
+	ERR_FAIL_COND_V_MSG(reader.has_overrun(), ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	// Both builds return null when the bytes do not decode, and the encoder always writes an Array.
+	const Variant decoded_variants = decode_variant(p_bytes.slice(variant_offset, variant_offset + variant_size), allow_objects);
+	ERR_FAIL_COND_V_MSG(decoded_variants.get_type() != Variant::ARRAY, ERR_FILE_CORRUPT, "Saveload file has corrupt variant values.");
+	variants = decoded_variants;
+	variant_index = 0;
+	corrupt = false;
+	spawn_args.clear();
+
+	// Map the file's path table onto interned path IDs.
+	path_count = 0;
+	if (version >= SaveloadEncoder::VERSION_PATH_TABLE) {
+		SaveloadPathTable *paths = SaveloadPathTable::get_singleton();
+		path_count = reader.get_u32();
+		ERR_FAIL_COND_V_MSG(path_count > reader.get_remaining() / sizeof(uint32_t), ERR_FILE_CORRUPT, "Saveload file has an invalid path table.");
+		path_ids = arena->alloc_array<uint32_t>(path_count);
+		ERR_FAIL_NULL_V(path_ids, ERR_OUT_OF_MEMORY);
+		for (uint32_t i = 0; i < path_count; i++) {
+			path_ids[i] = paths->intern(NodePath(reader.get_string()));
+		}
+	}
+	LocalVector<String> resource_paths;
+	if (version >= SaveloadEncoder::VERSION_RESOURCE_TABLE) {
+		const uint32_t resource_count = reader.get_u32();
+		ERR_FAIL_COND_V_MSG(resource_count > reader.get_remaining() / sizeof(uint32_t), ERR_FILE_CORRUPT, "Saveload file has an invalid resource table.");
+		resource_paths.resize(resource_count);
+		for (uint32_t i = 0; i < resource_count; i++) {
+			resource_paths[i] = reader.get_string();
+		}
+	}
+	ERR_FAIL_COND_V_MSG(reader.has_overrun(), ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	_load_resources(resource_paths);
+
+	const uint32_t spawner_count = reader.get_u32();
+	for (uint32_t i = 0; i < spawner_count && !reader.has_overrun(); i++) {
+		const uint32_t spawner_path_id = _read_path_id(reader);
+		const uint32_t spawn_count = reader.get_u32();
+		// Each spawn takes at least three u32s, or two before spawn argument IDs, so this bounds the allocation below.
+		const uint32_t min_spawn_size = (version >= SaveloadEncoder::VERSION_SPAWN_ARG_IDS ? 3 : 2) * sizeof(uint32_t);
+		ERR_FAIL_COND_V_MSG(spawn_count > reader.get_remaining() / min_spawn_size, ERR_FILE_CORRUPT, "Saveload file has an invalid spawner.");
+		LocalVector<SaveloadSpawner::SpawnInfo> &spawn_infos = r_saveload_state.spawner_states.insert(spawner_path_id, SaveloadSpawner::SpawnerState())->value.spawn_infos;
+		spawn_infos.reserve(spawn_count);
+		for (uint32_t j = 0; j < spawn_count && !reader.has_overrun(); j++) {
+			const uint32_t spawn_path_id = _read_path_id(reader);
+			const int scene_index = (int)reader.get_u32();
+			const uint32_t spawn_arg_id = version >= SaveloadEncoder::VERSION_SPAWN_ARG_IDS ? reader.get_u32() : spawn_args.size();
+			if (spawn_arg_id == spawn_args.size()) {
+				spawn_args.push_back(_get_variant());
+			}
+			ERR_FAIL_COND_V_MSG(spawn_arg_id >= spawn_args.size(), ERR_FILE_CORRUPT, "Saveload file references spawn arguments it has not defined.");
+			spawn_infos.push_back(SaveloadSpawner::SpawnInfo(spawn_path_id, scene_index, spawn_args[spawn_arg_id]));
+		}
+	}
+
+	const uint32_t group_count = reader.get_u32();
+	r_saveload_state.syncher_groups.reserve(group_count);
+	for (uint32_t i = 0; i < group_count && !reader.has_overrun(); i++) {
+		const uint32_t property_count = reader.get_u32();
+		const uint32_t instance_count = reader.get_u32();
+		// Every instance path is at least its length prefix, so this bounds the allocation below.
+		ERR_FAIL_COND_V_MSG(instance_count > reader.get_remaining() / sizeof(uint32_t), ERR_FILE_CORRUPT, "Saveload file has an invalid synchronizer group.");
+		r_saveload_state.syncher_groups.push_back(SceneSaveload::SyncherGroup());
+		SceneSaveload::SyncherGroup &group = r_saveload_state.syncher_groups[r_saveload_state.syncher_groups.size() - 1];
+		// Older groups keep a fingerprint no config has, so every registered migration sees them.
+		group.fingerprint = version >= SaveloadEncoder::VERSION_FINGERPRINTS ? reader.get_u64() : 0;
+		group.synchers.resize(instance_count);
+		for (uint32_t j = 0; j < instance_count; j++) {
+			group.synchers[j] = _read_path_id(reader);
+		}
+		for (uint32_t j = 0; j < property_count && !reader.has_overrun(); j++) {
+			group.properties.push_back(_read_path_id(reader));
+			const uint8_t column = reader.get_u8();
+			const uint8_t encoding = reader.get_u8();
+			ERR_FAIL_COND_V_MSG(column >= SaveloadEncoder::COLUMN_MAX || encoding >= SceneSaveloadConfig::ENCODING_MAX, ERR_FILE_CORRUPT, "Saveload file has an invalid column.");
+			Vector2 range;
+			if (encoding == SceneSaveloadConfig::ENCODING_FIXED_16) {
+				range.x = reader.get_float();
+				range.y = reader.get_float();
+				ERR_FAIL_COND_V_MSG(!SceneSaveloadConfig::is_valid_encoding_range(range), ERR_FILE_CORRUPT, "Saveload file has an invalid encoding range.");
+			}
+			const uint8_t *missing_bits = nullptr;
+			if (version >= SaveloadEncoder::VERSION_PRESENCE_MASKS && reader.get_u8() && instance_count > 0) {
+				missing_bits = reader.get_span((instance_count + 7) / 8);
+				ERR_FAIL_NULL_V_MSG(missing_bits, ERR_FILE_CORRUPT, "Saveload file is truncated.");
+				// Properties without flags of their own are left with an empty vector, which is_missing() allows.
+				group.missing.resize(j + 1);
+				group.missing[j].resize(instance_count);
+				memset(group.missing[j].ptr(), 0, instance_count);
+			}
+			group.columns.push_back(LocalVector<Variant>());
+			LocalVector<Variant> &values = group.columns[j];
+			values.resize(instance_count);
+			for (uint32_t k = 0; k < instance_count; k++) {
+				if (missing_bits && (missing_bits[k / 8] & (1 << (k % 8)))) {
+					group.missing[j][k] = 1;
+					continue;
+				}
+				values[k] = _get_value((SaveloadEncoder::Column)column, (SaveloadEncoder::Encoding)encoding, range);
+			}
+		}
+	}
+
+	ERR_FAIL_COND_V_MSG(reader.has_overrun(), ERR_FILE_CORRUPT, "Saveload file is truncated.");
+	ERR_FAIL_COND_V_MSG(path_overrun, ERR_FILE_CORRUPT, "Saveload file references a path outside its path table.");
+	ERR_FAIL_COND_V_MSG(corrupt, ERR_FILE_CORRUPT, "Saveload file references values or resources outside its tables.");
+	// Every variant is referenced exactly once, so any left over mean the tables and values disagree.
+	ERR_FAIL_COND_V_MSG(variant_index != (uint32_t)variants.size(), ERR_FILE_CORRUPT, "Saveload file has more values than its tables reference.");
+	for (int i = SaveloadEncoder::COLUMN_VARIANT + 1; i < SaveloadEncoder::COLUMN_MAX; i++) {
+		for (int j = 0; j < SceneSaveloadConfig::ENCODING_MAX; j++) {
+			ERR_FAIL_COND_V_MSG(columns[i][j].has_overrun(), ERR_FILE_CORRUPT, "Saveload file has fewer values than its tables reference.");
+		}
+	}
+	return OK;
+}
+
+/***********************************
+ * SaveloadDecoder Definitions End *
+ ***********************************/
@@ -0,0 +1,349 @@
+/**************************************************************************/
+/*  saveload_encoder.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAVELOAD_ENCODER_H
+#define SAVELOAD_ENCODER_H
+
+#include "saveload_arena.h"
+#include "scene_saveload.h"
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+#endif
+
+// Growable little-endian byte buffer. Every platform Godot ships on is little-endian,
+// so values are copied as they are laid out in memory.
+class SaveloadWriter {
+	LocalVector<uint8_t> data;
+	uint32_t capacity = 0;
+	uint32_t grow_count = 0; // Since the last clear().
+
+	void _grow(uint32_t p_size);
+
+public:
+	void put_data(const void *p_data, uint32_t p_size);
+
+	_FORCE_INLINE_ void put_u8(uint8_t p_value) {
+		if (data.size() == capacity) {
+			_grow(capacity + 1);
+		}
+		data.push_back(p_value);
+	}
+	_FORCE_INLINE_ void put_u16(uint16_t p_value) { put_data(&p_value, sizeof(p_value)); }
+	_FORCE_INLINE_ void put_u32(uint32_t p_value) { put_data(&p_value, sizeof(p_value)); }
+	_FORCE_INLINE_ void put_u64(uint64_t p_value) { put_data(&p_value, sizeof(p_value)); }
+	_FORCE_INLINE_ void put_float(float p_value) { put_data(&p_value, sizeof(p_value)); }
+	_FORCE_INLINE_ void put_double(double p_value) { put_data(&p_value, sizeof(p_value)); }
+	_FORCE_INLINE_ void put_real(real_t p_value) { put_data(&p_value, sizeof(p_value)); }
+
+	void put_string(const String &p_string);
+
+	_FORCE_INLINE_ uint32_t size() const { return data.size(); }
+	_FORCE_INLINE_ const uint8_t *ptr() const { return data.ptr(); }
+	_FORCE_INLINE_ uint32_t get_grow_count() const { return grow_count; }
+
+	// Keeps the memory, so a writer reused for data of a similar size does not allocate again.
+	_FORCE_INLINE_ void clear() {
+		data.clear();
+		grow_count = 0;
+	}
+};
+
+// Bounds-checked reader over a byte range it does not own. Reads past the end
+// return zero and set the overrun flag, so callers can check once per section.
+class SaveloadReader {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t position = 0;
+	bool overrun = false;
+
+public:
+	const uint8_t *get_span(uint32_t p_size);
+	bool get_data(void *r_data, uint32_t p_size);
+
+	uint8_t get_u8();
+	uint16_t get_u16();
+	uint32_t get_u32();
+	uint64_t get_u64();
+	float get_float();
+	double get_double();
+	real_t get_real(uint8_t p_real_size);
+
+	String get_string();
+
+	_FORCE_INLINE_ bool has_overrun() const { return overrun; }
+	_FORCE_INLINE_ uint32_t get_position() const { return position; }
+	_FORCE_INLINE_ uint32_t get_remaining() const { return size - position; }
+
+	SaveloadReader(const uint8_t *p_data, uint32_t p_size) {
+		data = p_data;
+		size = p_size;
+	}
+
+	SaveloadReader() {}
+};
+
+// Binary save format. Values of common math types are written untagged into one
+// packed column per type and encoding, so that e.g. every Transform3D in a save is
+// a single contiguous block. Everything else goes through a single var_to_bytes call.
+//
+// Layout:
+//   u32 magic, u32 version, u8 sizeof(real_t), u8 compression, u32 payload size,
+//   then for each of the four payload sections below: u32 size, u64 hash of its uncompressed bytes
+//   u32 stored size, u64 hash of the stored bytes, only set when the payload is compressed
+//   payload, compressed as a whole unless compression is COMPRESSION_NONE:
+//   u32 column count, then for each non-empty column: u8 column, u8 encoding, u8 transform, u32 size, data
+//   u32 size, var_to_bytes(Array) of untyped values and spawn arguments
+//   u32 path count, then each path as a string, u32 resource count, then each resource path as a string
+//   spawner table, synchronizer group table, which refer to paths by their index in the path table
+//
+// Spawn arguments are written once per distinct value. Each spawn refers to its arguments by
+// number; a number one past the highest seen so far means the next value in the variants.
+//
+// Synchronizers sharing a config form one group. Its schema fingerprint and property paths are
+// written once, followed by the instance paths, and each property's values are contiguous in its column.
+// After its column and encoding, each property has a u8 that is 1 if some synchronizers could not read
+// it, followed by a bit per instance set for those; their values are left out of the column.
+//
+// Files from MIN_FORMAT_VERSION on are still decoded. Each VERSION_* constant below is the version
+// that introduced a part of this layout; older files lack it, and their groups load with an unknown
+// fingerprint so that registered migrations bring them up to date.
+class SaveloadEncoder {
+public:
+	enum Section {
+		SECTION_COLUMNS,
+		SECTION_VARIANTS,
+		SECTION_PATHS,
+		SECTION_TABLES,
+		SECTION_MAX,
+	};
+
+	enum {
+		FORMAT_MAGIC = 0x444C5653, // "SVLD"
+		FORMAT_VERSION = 11,
+		MIN_FORMAT_VERSION = 4, // Before it, the header had no compression byte.
+		VERSION_PATH_TABLE = 5, // Paths were written inline as strings before.
+		VERSION_SECTION_TABLE = 6, // The header ended at SECTION_TABLE_OFFSET before, without section hashes.
+		VERSION_SPAWN_ARG_IDS = 7, // Each spawn took the next value in the variants before.
+		VERSION_RESOURCE_TABLE = 8,
+		VERSION_FINGERPRINTS = 9,
+		VERSION_PRESENCE_MASKS = 10,
+		VERSION_STORED_HASH = 11, // Compressed files could only be checked by inflating them before.
+		SECTION_TABLE_OFFSET = 14,
+		SECTION_ENTRY_SIZE = sizeof(uint32_t) + sizeof(uint64_t),
+		STORED_OFFSET = SECTION_TABLE_OFFSET + SECTION_MAX * SECTION_ENTRY_SIZE,
+		HEADER_SIZE = STORED_OFFSET + sizeof(uint32_t) + sizeof(uint64_t),
+		COMPRESSION_NONE = 0xFF, // Any other value is a FileAccess::CompressionMode.
+		// Bounds on the payload size a compressed file may claim, checked before decompressing into it.
+		// Zstandard stores a run of equal bytes in a few bytes per 128 KiB block, hence the high ratio.
+		MAX_PAYLOAD_SIZE = 1 << 30,
+		MAX_COMPRESSION_RATIO = 1 << 15,
+	};
+
+	enum Transform : uint8_t {
+		TRANSFORM_NONE,
+		TRANSFORM_XOR_SHUFFLE, // Each value XORed with the previous one, then byte-shuffled.
+		TRANSFORM_MAX,
+	};
+
+	enum Column : uint8_t {
+		COLUMN_VARIANT,
+		COLUMN_INT,
+		COLUMN_FLOAT,
+		COLUMN_VECTOR2,
+		COLUMN_VECTOR3,
+		COLUMN_QUATERNION,
+		COLUMN_TRANSFORM3D,
+		COLUMN_COLOR,
+		COLUMN_RESOURCE, // Index into the resource table plus one, or zero for null.
+		COLUMN_MAX,
+	};
+
+	typedef SceneSaveloadConfig::PropertyEncoding Encoding;
+
+	static Column get_column(Variant::Type p_type);
+
+	static bool supports_encoding(Column p_column, Encoding p_encoding);
+
+	// Objects are only encoded with p_allow_objects, and decoding them can run scripts.
+	static PackedByteArray encode_variant(const Variant &p_variant, bool p_allow_objects = false);
+
+	// Whether p_value can be stored as a reference to the file it was loaded from. Without
+	// p_allow_objects, only resources of the project itself qualify, see is_trusted_resource_path().
+	static bool is_resource_reference(const Variant &p_value, bool p_allow_objects = false);
+
+	// Loading a resource can run its scripts, so files saved or loaded without allow_objects
+	// may only reference resources under res://, which ship with the project.
+	static bool is_trusted_resource_path(const String &p_path) { return p_path.begins_with("res://"); }
+
+	// Size of one value and of its components, used to pick the column transform.
+	static void get_value_layout(Column p_column, Encoding p_encoding, uint8_t p_real_size, uint32_t &r_value_size, uint32_t &r_component_size);
+
+	static bool is_supported_version(uint32_t p_version) { return p_version >= MIN_FORMAT_VERSION && p_version <= FORMAT_VERSION; }
+	static uint32_t get_header_size(uint32_t p_version) { return p_version < VERSION_SECTION_TABLE ? SECTION_TABLE_OFFSET : (p_version < VERSION_STORED_HASH ? STORED_OFFSET : HEADER_SIZE); }
+
+	// Compresses the payload of a file produced by encode() in place. p_mode is a
+	// FileAccess::CompressionMode, or COMPRESSION_NONE to leave the file as it is.
+	static Error compress(PackedByteArray &r_bytes, int p_mode);
+
+	// Pass the hash of the bytes before p_data as p_hash to hash a section in pieces.
+	static uint64_t hash_section(const uint8_t *p_data, uint32_t p_size, uint64_t p_hash = 0xCBF29CE484222325);
+
+	// Whether p_header, the start of an existing file, has the same section hashes as the
+	// uncompressed file p_bytes and was written with compression p_mode. The stored size and hash
+	// are not compared, as p_bytes has not been compressed yet.
+	static bool has_same_content(const PackedByteArray &p_bytes, const PackedByteArray &p_header, int p_mode);
+
+private:
+	struct PropertyFormat {
+		Variant::Type type = Variant::NIL;
+		Encoding encoding = SceneSaveloadConfig::ENCODING_DEFAULT;
+		Vector2 range;
+	};
+
+	SaveloadWriter columns[COLUMN_MAX][SceneSaveloadConfig::ENCODING_MAX];
+	Array variants;
+	SaveloadWriter tables;
+	SaveloadWriter path_table;
+	SaveloadWriter column_directory;
+	SaveloadWriter header;
+	LocalVector<uint8_t> transform_buffer;
+	HashMap<uint64_t, HashMap<NodePath, PropertyFormat>> config_formats;
+	LocalVector<uint32_t> file_path_ids; // Interned path ID to index in the file's path table, or INVALID_ID.
+	LocalVector<uint32_t> file_paths;
+	uint32_t allocation_count = 0;
+	HashMap<Variant, uint32_t, VariantHasher, VariantComparator> spawn_arg_ids; // Distinct spawn arguments, numbered in order of first use.
+	HashMap<String, uint32_t> resource_ids; // Resource path to index in the file's resource table.
+	LocalVector<String> resource_paths;
+	bool allow_objects = false;
+
+	uint32_t _get_file_path_id(uint32_t p_path_id);
+	uint32_t _get_spawn_arg_id(const Variant &p_spawn_args);
+	uint32_t _get_resource_id(const String &p_path);
+
+	PropertyFormat _get_property_format(const Ref<SceneSaveloadConfig> &p_config, const NodePath &p_property);
+	void _put_value(Column p_column, Encoding p_encoding, const Vector2 &p_range, const Variant &p_value);
+
+public:
+	// Times the last encode() had to grow one of its buffers or add a hash map entry. An encoder
+	// kept across saves of a similar size settles at the few entries per config and spawn argument.
+	uint32_t get_allocation_count() const { return allocation_count; }
+
+	// Lets untyped values embed objects, such as resources not saved to a file of their own.
+	void set_allow_objects(bool p_allow) { allow_objects = p_allow; }
+
+	Error encode(const SceneSaveload::SaveloadState &p_saveload_state, PackedByteArray &r_bytes);
+};
+
+class SaveloadDecoder {
+	SaveloadReader columns[SaveloadEncoder::COLUMN_MAX][SceneSaveloadConfig::ENCODING_MAX];
+	SaveloadArena own_arena;
+	SaveloadArena *arena = &own_arena; // Backs transformed columns and the path ID map.
+	Array variants;
+	uint32_t variant_index = 0;
+	uint8_t real_size = sizeof(real_t);
+	uint32_t *path_ids = nullptr; // Index in the file's path table to interned path ID.
+	uint32_t path_count = 0;
+	LocalVector<Variant> spawn_args; // Shared by every spawn that references them.
+	LocalVector<Variant> resources; // Loaded once per path in the file's resource table.
+	bool allow_objects = false;
+	bool threaded_resources = false;
+	bool path_overrun = false;
+	bool corrupt = false; // Set when a value references past the end of the variants or resources.
+	uint32_t version = SaveloadEncoder::FORMAT_VERSION; // Of the file being decoded.
+
+	uint32_t _get_path_id(uint32_t p_file_path_id);
+	// Reads a path reference, which files before VERSION_PATH_TABLE hold inline.
+	uint32_t _read_path_id(SaveloadReader &r_reader);
+	void _load_resources(const LocalVector<String> &p_paths);
+
+	enum {
+		VALIDATE_BLOCK_SIZE = 1024 * 1024,
+	};
+
+	struct HeaderInfo {
+		uint32_t header_size = 0; // Of the file's version.
+		uint32_t version = 0;
+		uint8_t compression = SaveloadEncoder::COMPRESSION_NONE;
+		// Files without a section table have zero sizes, and nothing for their sections to be checked against.
+		uint32_t section_sizes[SaveloadEncoder::SECTION_MAX] = {};
+		uint64_t section_hashes[SaveloadEncoder::SECTION_MAX] = {};
+		uint64_t stored_hash = 0; // Of the compressed payload, from VERSION_STORED_HASH on.
+
+		// Whether the hashes cover the bytes as stored, so checking them needs no decompression.
+		bool has_stored_hash() const { return compression != SaveloadEncoder::COMPRESSION_NONE && version >= SaveloadEncoder::VERSION_STORED_HASH; }
+		bool has_section_table() const { return version >= SaveloadEncoder::VERSION_SECTION_TABLE; }
+	};
+
+	static Error _validate_header(const PackedByteArray &p_header, uint64_t p_file_size, HeaderInfo &r_info);
+	// Checks a whole file held in memory. Only compressed files from before VERSION_STORED_HASH are
+	// decompressed, in place, as their hashes are of the uncompressed payload.
+	static Error _validate_bytes(PackedByteArray &r_bytes);
+
+	Variant _get_value(SaveloadEncoder::Column p_column, SaveloadEncoder::Encoding p_encoding, const Vector2 &p_range);
+	Variant _get_variant();
+
+public:
+	static bool has_magic(const PackedByteArray &p_bytes);
+
+	static Variant decode_variant(const PackedByteArray &p_bytes, bool p_allow_objects = false);
+
+	// Inverse of SaveloadEncoder::compress().
+	static Error decompress(PackedByteArray &r_bytes);
+
+	// Checks the header, section sizes and section hashes of the file at p_path without decoding
+	// any value or touching the scene tree, so it may run on any thread. Compressed files are checked
+	// against the hash of their stored bytes instead, without being decompressed. Chunked saves are
+	// restored from p_store_directory, or the directory their manifest names. Encrypted saves
+	// are authenticated and decrypted with p_encryption_key, or only have their size checked without it.
+	static Error validate(const String &p_path, const String &p_store_directory = String(), const PackedByteArray &p_encryption_key = PackedByteArray());
+
+	// Only enable for trusted files, as embedded objects may carry scripts.
+	void set_allow_objects(bool p_allow) { allow_objects = p_allow; }
+	// Loads referenced resources in parallel through ResourceLoader's threaded requests.
+	void set_threaded_resources(bool p_threaded) { threaded_resources = p_threaded; }
+
+	// Scratch memory for decoding. The caller resets it once the decoded state has been applied.
+	void set_arena(SaveloadArena *p_arena) { arena = p_arena ? p_arena : &own_arena; }
+
+	Error decode(const PackedByteArray &p_bytes, SceneSaveload::SaveloadState &r_saveload_state);
+};
+
+#endif // SAVELOAD_ENCODER_H
@@ -0,0 +1,181 @@
+/**************************************************************************/
+/*  saveload_file_writer.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "saveload_file_writer.h"
+
+#include <string.h>
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/config/project_settings.h"
+#include "core/io/file_access.h"
+
+#endif
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+
+// Numbers the temporary files of this process, so that a save and a queued save task
+// writing the same path never write to the same file.
+static std::atomic<uint32_t> temp_file_counter(0);
+#endif
+
+Error SaveloadFileWriter::write(const String &p_path, const PackedByteArray &p_bytes, bool p_uncached) {
+	if (p_uncached) {
+		const Error err = _write_uncached(p_path, p_bytes);
+		if (err != ERR_UNAVAILABLE) {
+			return err;
+		}
+	}
+	return _write_file_access(p_path, p_bytes);
+}
+
+Error SaveloadFileWriter::_write_file_access(const String &p_path, const PackedByteArray &p_bytes) {
+	Error err;
+#ifdef GDEXTENSION
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	err = FileAccess::get_open_error();
+#elif
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+#endif
+	if (err != OK) {
+		return err;
+	}
+	file->store_buffer(p_bytes);
+	err = file->get_error();
+	file->close();
+	ERR_FAIL_COND_V_MSG(err != OK, ERR_FILE_CANT_WRITE, vformat("Could not write %s.", p_path));
+	return OK;
+}
+
+// Returns ERR_UNAVAILABLE when the caller should fall back to FileAccess.
+Error SaveloadFileWriter::_write_uncached(const String &p_path, const PackedByteArray &p_bytes) {
+#ifdef __linux__
+	const String path = ProjectSettings::get_singleton()->globalize_path(p_path);
+	if (path.find("://") != -1) {
+		// Not on the native filesystem, such as a path inside a pack.
+		return ERR_UNAVAILABLE;
+	}
+	const CharString utf8 = path.utf8();
+	// Written under a temporary name and renamed over the save once synced, so a failed
+	// write leaves the previous save as it was.
+	const CharString temp_utf8 = vformat("%s.%d-%d.tmp", path, getpid(), temp_file_counter.fetch_add(1)).utf8();
+	int fd = open(temp_utf8.get_data(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC | O_DIRECT, 0666);
+	bool direct = fd >= 0;
+	if (fd < 0 && errno == EINVAL) {
+		// The filesystem does not support O_DIRECT, as with tmpfs. Dropping the pages afterwards still applies.
+		fd = open(temp_utf8.get_data(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+	}
+	ERR_FAIL_COND_V_MSG(fd < 0, ERR_FILE_CANT_OPEN, vformat("Could not open %s for writing.", path));
+
+	const uint8_t *data = p_bytes.ptr();
+	const uint64_t size = p_bytes.size();
+	void *buffer = nullptr;
+	if (direct && posix_memalign(&buffer, DIRECT_ALIGNMENT, DIRECT_WRITE_SIZE) != 0) {
+		close(fd);
+		unlink(temp_utf8.get_data());
+		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Could not allocate an aligned write buffer.");
+	}
+	Error err = OK;
+	for (uint64_t offset = 0; offset < size && err == OK;) {
+		uint64_t length = MIN(size - offset, (uint64_t)DIRECT_WRITE_SIZE);
+		const uint8_t *source = data + offset;
+		if (direct) {
+			// O_DIRECT needs aligned memory and lengths, so the tail is padded and truncated away below.
+			memcpy(buffer, source, length);
+			const uint64_t padded = (length + DIRECT_ALIGNMENT - 1) & ~(uint64_t)(DIRECT_ALIGNMENT - 1);
+			memset((uint8_t *)buffer + length, 0, padded - length);
+			source = (const uint8_t *)buffer;
+			offset += length;
+			length = padded;
+		} else {
+			offset += length;
+		}
+		while (length > 0) {
+			const ssize_t written = ::write(fd, source, length);
+			if (written < 0 && errno == EINTR) {
+				continue;
+			}
+			if (written <= 0) {
+				err = ERR_FILE_CANT_WRITE;
+				break;
+			}
+			source += written;
+			length -= written;
+			if (direct && length > 0) {
+				// A short write leaves the file offset unaligned, which O_DIRECT rejects, so the
+				// rest of the file is written through the page cache instead.
+				const int flags = fcntl(fd, F_GETFL);
+				if (flags < 0 || fcntl(fd, F_SETFL, flags & ~O_DIRECT) != 0) {
+					err = ERR_FILE_CANT_WRITE;
+					break;
+				}
+				direct = false;
+			}
+		}
+	}
+	if (buffer) {
+		// Aligned writes pad the tail, even when they were given up on partway, so cut it off.
+		free(buffer);
+		if (err == OK && ftruncate(fd, size) != 0) {
+			err = ERR_FILE_CANT_WRITE;
+		}
+	}
+	if (err == OK && fdatasync(fd) != 0) {
+		err = ERR_FILE_CANT_WRITE;
+	}
+	// Written pages are only dropped once they are clean, hence the sync first.
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	close(fd);
+	if (err == OK && rename(temp_utf8.get_data(), utf8.get_data()) != 0) {
+		err = ERR_FILE_CANT_WRITE;
+	}
+	if (err != OK) {
+		unlink(temp_utf8.get_data());
+		ERR_FAIL_V_MSG(err, vformat("Could not write %s.", path));
+	}
+	return OK;
+#else
+	return ERR_UNAVAILABLE;
+#endif
+}
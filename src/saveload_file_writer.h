@@ -0,0 +1,68 @@
+/**************************************************************************/
+/*  saveload_file_writer.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAVELOAD_FILE_WRITER_H
+#define SAVELOAD_FILE_WRITER_H
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/string/ustring.h"
+#include "core/variant/variant.h"
+
+#endif
+
+// Writes finished save files. Saves are encoded into a single buffer, so the default path is
+// one FileAccess write. Uncached writes are for dedicated servers hosting many sessions, whose
+// saves would otherwise crowd the page cache: on Linux the file is written with O_DIRECT in
+// large aligned blocks to a temporary file, then synced, dropped from the cache and renamed over
+// the previous save. Elsewhere, or for paths outside the native filesystem, they fall back to
+// the default path.
+class SaveloadFileWriter {
+public:
+	enum {
+		DIRECT_ALIGNMENT = 4096, // Covers the logical block size of common devices.
+		DIRECT_WRITE_SIZE = 4 * 1024 * 1024,
+	};
+
+	static Error write(const String &p_path, const PackedByteArray &p_bytes, bool p_uncached = false);
+
+private:
+	static Error _write_file_access(const String &p_path, const PackedByteArray &p_bytes);
+	static Error _write_uncached(const String &p_path, const PackedByteArray &p_bytes);
+};
+
+#endif // SAVELOAD_FILE_WRITER_H
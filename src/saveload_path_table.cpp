@@ -0,0 +1,82 @@
+/**************************************************************************/
+/*  saveload_path_table.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "saveload_path_table.h"
+
+SaveloadPathTable *SaveloadPathTable::singleton = nullptr;
+
+SaveloadPathTable *SaveloadPathTable::get_singleton() {
+	return singleton;
+}
+
+uint32_t SaveloadPathTable::intern(const NodePath &p_path) {
+	HashMap<NodePath, uint32_t>::ConstIterator id = ids.find(p_path);
+	if (id) {
+		return id->value;
+	}
+	uint32_t new_id;
+	if (free_ids.is_empty()) {
+		new_id = paths.size();
+		paths.push_back(p_path);
+		flags.push_back(FLAG_LIVE);
+	} else {
+		new_id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+		paths[new_id] = p_path;
+		flags[new_id] = FLAG_LIVE;
+	}
+	ids.insert(p_path, new_id);
+	live_count++;
+	return new_id;
+}
+
+uint32_t SaveloadPathTable::find(const NodePath &p_path) const {
+	HashMap<NodePath, uint32_t>::ConstIterator id = ids.find(p_path);
+	return id ? id->value : INVALID_ID;
+}
+
+uint32_t SaveloadPathTable::sweep() {
+	uint32_t freed = 0;
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		if (flags[i] & FLAG_MARKED) {
+			flags[i] = FLAG_LIVE;
+		} else if (flags[i] & FLAG_LIVE) {
+			ids.erase(paths[i]);
+			paths[i] = NodePath();
+			flags[i] = 0;
+			free_ids.push_back(i);
+			freed++;
+		}
+	}
+	live_count -= freed;
+	// Collecting again only once the table doubles keeps the cost per interned path constant.
+	collect_threshold = MAX((uint32_t)MIN_COLLECT_THRESHOLD, live_count * 2);
+	return freed;
+}
@@ -0,0 +1,107 @@
+/**************************************************************************/
+/*  saveload_path_table.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAVELOAD_PATH_TABLE_H
+#define SAVELOAD_PATH_TABLE_H
+
+#ifdef GDEXTENSION
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/node_path.hpp>
+
+using namespace godot;
+
+#elif
+
+#include "core/string/node_path.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+#endif
+
+// Interns NodePaths into dense IDs, so saveload state can store, hash and compare
+// a u32 instead of a full path. The table is only touched from the main thread.
+//
+// Paths are never freed one by one, as nothing counts how many states hold an ID. Instead
+// SceneSaveload marks every ID it still holds once enough paths have been interned since the
+// last collection, and sweep() frees the rest for reuse. An ID stays valid until the first
+// sweep() that finds it unmarked.
+class SaveloadPathTable {
+	static SaveloadPathTable *singleton;
+
+	enum : uint8_t {
+		FLAG_LIVE = 1,
+		FLAG_MARKED = 2,
+	};
+
+	HashMap<NodePath, uint32_t> ids;
+	LocalVector<NodePath> paths;
+	LocalVector<uint8_t> flags;
+	LocalVector<uint32_t> free_ids;
+	uint32_t live_count = 0;
+	uint32_t collect_threshold = MIN_COLLECT_THRESHOLD;
+	NodePath empty_path; // Returned for invalid IDs.
+
+public:
+	enum : uint32_t {
+		INVALID_ID = UINT32_MAX,
+		MIN_COLLECT_THRESHOLD = 1024, // Live paths below which collecting is not worth it.
+	};
+
+	static SaveloadPathTable *get_singleton();
+
+	uint32_t intern(const NodePath &p_path);
+	uint32_t find(const NodePath &p_path) const; // INVALID_ID if the path is not interned.
+
+	// An empty path for INVALID_ID, freed IDs and any other ID outside the table.
+	_FORCE_INLINE_ const NodePath &get_path(uint32_t p_id) const { return is_valid(p_id) ? paths[p_id] : empty_path; }
+	_FORCE_INLINE_ bool is_valid(uint32_t p_id) const { return p_id < paths.size() && (flags[p_id] & FLAG_LIVE); }
+	_FORCE_INLINE_ uint32_t size() const { return paths.size(); } // One past the highest ID handed out.
+	_FORCE_INLINE_ uint32_t get_live_count() const { return live_count; }
+
+	// Whether the table has grown enough since the last sweep() to be worth collecting.
+	_FORCE_INLINE_ bool needs_collect() const { return live_count >= collect_threshold; }
+
+	_FORCE_INLINE_ void mark(uint32_t p_id) {
+		if (is_valid(p_id)) {
+			flags[p_id] |= FLAG_MARKED;
+		}
+	}
+
+	// Frees every path not marked since the last sweep and returns how many were freed.
+	uint32_t sweep();
+
+	SaveloadPathTable() { singleton = this; }
+
+	~SaveloadPathTable() { singleton = nullptr; }
+};
+
+#endif // SAVELOAD_PATH_TABLE_H
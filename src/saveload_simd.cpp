@@ -0,0 +1,213 @@
+/**************************************************************************/
+/*  saveload_simd.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "saveload_simd.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAVELOAD_SSE2
+#include <emmintrin.h>
+#ifdef __AVX2__
+#define SAVELOAD_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SAVELOAD_NEON
+#include <arm_neon.h>
+#endif
+
+void SaveloadSimd::xor_neighbours(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_stride) {
+	if (p_stride > p_size) {
+		p_stride = p_size;
+	}
+	memcpy(r_dst, p_src, p_stride);
+	uint32_t i = p_stride;
+	// Every output byte only reads the source, so the vector paths need no care about overlap.
+#ifdef SAVELOAD_AVX2
+	for (; i + 32 <= p_size; i += 32) {
+		const __m256i current = _mm256_loadu_si256((const __m256i *)(p_src + i));
+		const __m256i previous = _mm256_loadu_si256((const __m256i *)(p_src + i - p_stride));
+		_mm256_storeu_si256((__m256i *)(r_dst + i), _mm256_xor_si256(current, previous));
+	}
+#endif
+#if defined(SAVELOAD_SSE2)
+	for (; i + 16 <= p_size; i += 16) {
+		const __m128i current = _mm_loadu_si128((const __m128i *)(p_src + i));
+		const __m128i previous = _mm_loadu_si128((const __m128i *)(p_src + i - p_stride));
+		_mm_storeu_si128((__m128i *)(r_dst + i), _mm_xor_si128(current, previous));
+	}
+#elif defined(SAVELOAD_NEON)
+	for (; i + 16 <= p_size; i += 16) {
+		vst1q_u8(r_dst + i, veorq_u8(vld1q_u8(p_src + i), vld1q_u8(p_src + i - p_stride)));
+	}
+#endif
+	for (; i < p_size; i++) {
+		r_dst[i] = p_src[i] ^ p_src[i - p_stride];
+	}
+}
+
+void SaveloadSimd::unxor_neighbours(uint8_t *r_data, uint32_t p_size, uint32_t p_stride) {
+	if (p_stride == 0) {
+		return;
+	}
+	uint32_t i = p_stride;
+	// Each byte depends on an already decoded one, so a vector can only cover
+	// bytes whose predecessors all lie before it, i.e. when the stride is at least a vector wide.
+#if defined(SAVELOAD_SSE2)
+	if (p_stride >= 16) {
+		for (; i + 16 <= p_size; i += 16) {
+			const __m128i current = _mm_loadu_si128((const __m128i *)(r_data + i));
+			const __m128i previous = _mm_loadu_si128((const __m128i *)(r_data + i - p_stride));
+			_mm_storeu_si128((__m128i *)(r_data + i), _mm_xor_si128(current, previous));
+		}
+	}
+#elif defined(SAVELOAD_NEON)
+	if (p_stride >= 16) {
+		for (; i + 16 <= p_size; i += 16) {
+			vst1q_u8(r_data + i, veorq_u8(vld1q_u8(r_data + i), vld1q_u8(r_data + i - p_stride)));
+		}
+	}
+#endif
+	for (; i < p_size; i++) {
+		r_data[i] ^= r_data[i - p_stride];
+	}
+}
+
+void SaveloadSimd::shuffle(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_width) {
+	if (p_width <= 1) {
+		memcpy(r_dst, p_src, p_size);
+		return;
+	}
+	const uint32_t count = p_size / p_width;
+	uint32_t i = 0;
+#if defined(SAVELOAD_SSE2)
+	if (p_width == 4) {
+		// Transposes sixteen 4-byte elements per iteration with three rounds of byte unpacks.
+		for (; i + 16 <= count; i += 16) {
+			const uint8_t *src = p_src + i * 4;
+			const __m128i a = _mm_loadu_si128((const __m128i *)(src));
+			const __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+			const __m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+			const __m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+			const __m128i ab_lo = _mm_unpacklo_epi8(a, b);
+			const __m128i ab_hi = _mm_unpackhi_epi8(a, b);
+			const __m128i cd_lo = _mm_unpacklo_epi8(c, d);
+			const __m128i cd_hi = _mm_unpackhi_epi8(c, d);
+			const __m128i ab_even = _mm_unpacklo_epi8(ab_lo, ab_hi);
+			const __m128i ab_odd = _mm_unpackhi_epi8(ab_lo, ab_hi);
+			const __m128i cd_even = _mm_unpacklo_epi8(cd_lo, cd_hi);
+			const __m128i cd_odd = _mm_unpackhi_epi8(cd_lo, cd_hi);
+			const __m128i ab_01 = _mm_unpacklo_epi8(ab_even, ab_odd); // Bytes 0 and 1 of elements 0-7.
+			const __m128i ab_23 = _mm_unpackhi_epi8(ab_even, ab_odd);
+			const __m128i cd_01 = _mm_unpacklo_epi8(cd_even, cd_odd); // Bytes 0 and 1 of elements 8-15.
+			const __m128i cd_23 = _mm_unpackhi_epi8(cd_even, cd_odd);
+			_mm_storeu_si128((__m128i *)(r_dst + i), _mm_unpacklo_epi64(ab_01, cd_01));
+			_mm_storeu_si128((__m128i *)(r_dst + count + i), _mm_unpackhi_epi64(ab_01, cd_01));
+			_mm_storeu_si128((__m128i *)(r_dst + count * 2 + i), _mm_unpacklo_epi64(ab_23, cd_23));
+			_mm_storeu_si128((__m128i *)(r_dst + count * 3 + i), _mm_unpackhi_epi64(ab_23, cd_23));
+		}
+	}
+#elif defined(SAVELOAD_NEON)
+	if (p_width == 2) {
+		for (; i + 16 <= count; i += 16) {
+			const uint8x16x2_t planes = vld2q_u8(p_src + i * 2);
+			vst1q_u8(r_dst + i, planes.val[0]);
+			vst1q_u8(r_dst + count + i, planes.val[1]);
+		}
+	} else if (p_width == 4) {
+		for (; i + 16 <= count; i += 16) {
+			const uint8x16x4_t planes = vld4q_u8(p_src + i * 4);
+			vst1q_u8(r_dst + i, planes.val[0]);
+			vst1q_u8(r_dst + count + i, planes.val[1]);
+			vst1q_u8(r_dst + count * 2 + i, planes.val[2]);
+			vst1q_u8(r_dst + count * 3 + i, planes.val[3]);
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		for (uint32_t j = 0; j < p_width; j++) {
+			r_dst[j * count + i] = p_src[i * p_width + j];
+		}
+	}
+	memcpy(r_dst + count * p_width, p_src + count * p_width, p_size - count * p_width);
+}
+
+void SaveloadSimd::unshuffle(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_width) {
+	if (p_width <= 1) {
+		memcpy(r_dst, p_src, p_size);
+		return;
+	}
+	const uint32_t count = p_size / p_width;
+	uint32_t i = 0;
+#if defined(SAVELOAD_SSE2)
+	if (p_width == 4) {
+		for (; i + 16 <= count; i += 16) {
+			const __m128i byte0 = _mm_loadu_si128((const __m128i *)(p_src + i));
+			const __m128i byte1 = _mm_loadu_si128((const __m128i *)(p_src + count + i));
+			const __m128i byte2 = _mm_loadu_si128((const __m128i *)(p_src + count * 2 + i));
+			const __m128i byte3 = _mm_loadu_si128((const __m128i *)(p_src + count * 3 + i));
+			const __m128i low_lo = _mm_unpacklo_epi8(byte0, byte1); // Bytes 0 and 1 of elements 0-7.
+			const __m128i low_hi = _mm_unpackhi_epi8(byte0, byte1);
+			const __m128i high_lo = _mm_unpacklo_epi8(byte2, byte3); // Bytes 2 and 3 of elements 0-7.
+			const __m128i high_hi = _mm_unpackhi_epi8(byte2, byte3);
+			uint8_t *dst = r_dst + i * 4;
+			_mm_storeu_si128((__m128i *)(dst), _mm_unpacklo_epi16(low_lo, high_lo));
+			_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(low_lo, high_lo));
+			_mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(low_hi, high_hi));
+			_mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(low_hi, high_hi));
+		}
+	}
+#elif defined(SAVELOAD_NEON)
+	if (p_width == 2) {
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x2_t planes;
+			planes.val[0] = vld1q_u8(p_src + i);
+			planes.val[1] = vld1q_u8(p_src + count + i);
+			vst2q_u8(r_dst + i * 2, planes);
+		}
+	} else if (p_width == 4) {
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x4_t planes;
+			planes.val[0] = vld1q_u8(p_src + i);
+			planes.val[1] = vld1q_u8(p_src + count + i);
+			planes.val[2] = vld1q_u8(p_src + count * 2 + i);
+			planes.val[3] = vld1q_u8(p_src + count * 3 + i);
+			vst4q_u8(r_dst + i * 4, planes);
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		for (uint32_t j = 0; j < p_width; j++) {
+			r_dst[i * p_width + j] = p_src[j * count + i];
+		}
+	}
+	memcpy(r_dst + count * p_width, p_src + count * p_width, p_size - count * p_width);
+}
@@ -0,0 +1,55 @@
+/**************************************************************************/
+/*  saveload_simd.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAVELOAD_SIMD_H
+#define SAVELOAD_SIMD_H
+
+#include <stdint.h>
+
+// Reversible byte transforms applied to packed value columns before compression.
+// Each kernel has an SSE2 (AVX2 where enabled at compile time) or NEON path and a
+// scalar fallback, and every path produces identical output.
+class SaveloadSimd {
+public:
+	// r_dst[i] = p_src[i] ^ p_src[i - p_stride], leaving the first p_stride bytes as they are.
+	// With p_stride set to the size of one value, each value is XORed with the previous
+	// instance's value, so similar neighbours turn into mostly zero bytes.
+	static void xor_neighbours(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_stride);
+	// Inverse of xor_neighbours, in place.
+	static void unxor_neighbours(uint8_t *r_data, uint32_t p_size, uint32_t p_stride);
+
+	// Groups byte k of every p_width-byte element together, so that e.g. the sign and
+	// exponent bytes of a float column form long runs. Trailing bytes that do not make
+	// up a whole element are copied unchanged.
+	static void shuffle(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_width);
+	static void unshuffle(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_width);
+};
+
+#endif // SAVELOAD_SIMD_H
@@ -54,20 +54,20 @@ using namespace godot;
 
 Dictionary SaveloadSpawner::SpawnInfo::to_dict() const {
 	Dictionary dict;
-	dict[StringName("path")] = path;
+	dict[StringName("path")] = get_path();
 	dict[StringName("scene_index")] = scene_index;
 	dict[StringName("spawn_args")] = spawn_args;
 	return dict;
 }
 
-SaveloadSpawner::SpawnInfo::SpawnInfo(NodePath p_path, int p_scene_index, Variant p_spawn_args = Variant()) {
-	path = p_path;
+SaveloadSpawner::SpawnInfo::SpawnInfo(uint32_t p_path_id, int p_scene_index, const Variant &p_spawn_args) {
+	path_id = p_path_id;
 	scene_index = p_scene_index;
 	spawn_args = p_spawn_args;
 }
 
 SaveloadSpawner::SpawnInfo::SpawnInfo(const Dictionary &p_dict) {
-	path = p_dict[StringName("path")];
+	path_id = SaveloadPathTable::get_singleton()->intern(p_dict[StringName("path")]);
 	scene_index = p_dict[StringName("scene_index")];
 	spawn_args = p_dict[StringName("spawn_args")];
 }
@@ -80,17 +80,22 @@ SaveloadSpawner::SpawnInfo::SpawnInfo(const Dictionary &p_dict) {
  * SpawnState Definitions Start *
  ********************************/
 
-bool SaveloadSpawner::SpawnerState::has(const NodePath &p_path) const {
-	return tracked_paths.has(p_path);
+bool SaveloadSpawner::SpawnerState::has(uint32_t p_path_id) const {
+	return tracked_paths.has(p_path_id);
 }
 
-bool SaveloadSpawner::SpawnerState::erase(const NodePath &p_path) {
-	if (!tracked_paths.has(p_path)) {
+bool SaveloadSpawner::SpawnerState::erase(uint32_t p_path_id) {
+	HashMap<uint32_t, uint32_t>::Iterator tracked = tracked_paths.find(p_path_id);
+	if (!tracked) {
 		return false;
 	}
-	int index = tracked_paths[p_path];
+	const uint32_t index = tracked->value;
+	tracked_paths.remove(tracked);
+	// Spawn order is kept, so every later entry moves down by one.
 	spawn_infos.remove_at(index);
-	tracked_paths.erase(p_path);
+	for (uint32_t i = index; i < spawn_infos.size(); i++) {
+		tracked_paths[spawn_infos[i].path_id] = i;
+	}
 	return true;
 }
 
@@ -108,13 +113,21 @@ TypedArray<Dictionary> SaveloadSpawner::SpawnerState::to_array() const {
 	return array;
 }
 
+void SaveloadSpawner::SpawnerState::set_spawn_infos(const TypedArray<Dictionary> &p_array) {
+	spawn_infos.clear();
+	spawn_infos.reserve(p_array.size());
+	for (int i = 0; i < p_array.size(); ++i) {
+		spawn_infos.push_back(SpawnInfo(p_array[i]));
+	}
+}
+
 SaveloadSpawner::SpawnerState::SpawnerState(const TypedArray<Dictionary> &p_array) {
 	tracked_paths.clear();
 	spawn_infos.clear();
 	spawn_infos.reserve(p_array.size());
 	for (int i = 0; i < p_array.size(); ++i) {
 		spawn_infos.push_back(SpawnInfo(p_array[i]));
-		tracked_paths.insert(spawn_infos[i].path, i);
+		tracked_paths.insert(spawn_infos[i].path_id, i);
 	}
 }
 
@@ -324,12 +337,17 @@ void SaveloadSpawner::_notification(int p_what) {
 			SaveloadAPI::get_singleton()->track(this);
 		} break;
 
+		case NOTIFICATION_PATH_RENAMED: {
+			path_id = SaveloadPathTable::INVALID_ID;
+		} break;
+
 		case NOTIFICATION_EXIT_TREE: {
 			_update_spawn_parent();
+			path_id = SaveloadPathTable::INVALID_ID;
 			LocalVector<SpawnInfo> spawn_infos = spawner_state.spawn_infos;
 			uint32_t size = spawner_state.size();
 			for (uint32_t i = 0; i < size; ++i) {
-				NodePath path = spawn_infos[size - 1 - i].path;
+				NodePath path = spawn_infos[size - 1 - i].get_path();
 				Node *node = get_node_or_null(path);
 				ERR_CONTINUE_MSG(!node, vformat("could not find node at path %s", path));
                 Callable node_exit_callable = callable_mp(this, &SaveloadSpawner::_node_exit);
@@ -341,8 +359,15 @@ void SaveloadSpawner::_notification(int p_what) {
 	}
 }
 
+uint32_t SaveloadSpawner::get_path_id() {
+	if (path_id == SaveloadPathTable::INVALID_ID && is_inside_tree()) {
+		path_id = SaveloadPathTable::get_singleton()->intern(get_path());
+	}
+	return path_id;
+}
+
 void SaveloadSpawner::_node_added(Node *p_node) {
-	if (spawner_state.has(p_node->get_path())) {
+	if (spawner_state.has(SaveloadPathTable::get_singleton()->find(p_node->get_path()))) {
 		return;
 	}
 	const Node *parent = get_spawn_parent();
@@ -368,19 +393,18 @@ void SaveloadSpawner::set_spawn_path(const NodePath &p_path) {
 }
 
 void SaveloadSpawner::_track(Node *p_node, int p_scene_index, const Variant &p_spawn_args) {
-	NodePath node_path = p_node->get_path();
-	if (!spawner_state.has(node_path)) { //TODO: Is this redundant with the checks in _noded_added?
-		SpawnInfo spawn_info = SpawnInfo(node_path, p_scene_index, p_spawn_args);
+	const uint32_t node_path_id = SaveloadPathTable::get_singleton()->intern(p_node->get_path());
+	if (!spawner_state.has(node_path_id)) { //TODO: Is this redundant with the checks in _noded_added?
+		SpawnInfo spawn_info = SpawnInfo(node_path_id, p_scene_index, p_spawn_args);
 		spawner_state.push_back(spawn_info);
-        Callable node_exit_callable = callable_mp(this, &SaveloadSpawner::_node_exit).bind(p_node);
+        Callable node_exit_callable = callable_mp(this, &SaveloadSpawner::_node_exit).bind(node_path_id);
         p_node->connect(StringName("tree_exiting"), node_exit_callable, CONNECT_ONE_SHOT);
         SaveloadAPI::get_singleton()->track(this);
 	}
 }
 
-void SaveloadSpawner::_node_exit(const Node *p_node) {
-    ERR_FAIL_NULL(p_node);
-	spawner_state.erase(p_node->get_path());
+void SaveloadSpawner::_node_exit(uint32_t p_path_id) {
+	spawner_state.erase(p_path_id);
 }
 
 int SaveloadSpawner::find_spawnable_scene_index_from_path(const String &p_scene) const {
@@ -395,9 +419,10 @@ int SaveloadSpawner::find_spawnable_scene_index_from_path(const String &p_scene)
 void SaveloadSpawner::load_spawn_state(const SaveloadSpawner::SpawnerState &p_spawner_state) {
 	free_tracked_nodes();
 	for (const SpawnInfo &spawn_info : p_spawner_state.spawn_infos) {
-        int64_t name_count = spawn_info.path.get_name_count();
-		ERR_CONTINUE_MSG(name_count < 1, vformat("spawn path %s does not contain a node name", spawn_info.path));
-		String spawn_name = spawn_path.get_name(name_count - 1);
+        const NodePath &path = spawn_info.get_path();
+        int64_t name_count = path.get_name_count();
+		ERR_CONTINUE_MSG(name_count < 1, vformat("spawn path %s does not contain a node name", path));
+		String spawn_name = path.get_name(name_count - 1);
 		_spawn(spawn_name, spawn_info.scene_index, spawn_info.spawn_args); // TODO: what do I do with spawn errors?
 	}
 }
@@ -406,8 +431,8 @@ void SaveloadSpawner::free_tracked_nodes() {
 	uint32_t size = spawner_state.size();
 	for (uint32_t i = 0; i < size; ++i) {
 		SpawnInfo spawn_info = spawner_state.spawn_infos[size - 1 - i];
-		Node *node = get_node_or_null(spawn_info.path);
-		ERR_CONTINUE_MSG(!node, vformat("could not find a Node at path %s", spawn_info.path));
+		Node *node = get_node_or_null(spawn_info.get_path());
+		ERR_CONTINUE_MSG(!node, vformat("could not find a Node at path %s", spawn_info.get_path()));
 		Node *parent = node->get_parent();
 		if (parent) {
 			parent->remove_child(node);
@@ -495,6 +520,15 @@ Node *SaveloadSpawner::instantiate_custom(const Variant &p_data) {
     return Object::cast_to<Node>(ret.operator Object *());
 }
 
+SaveloadSpawner::~SaveloadSpawner() {
+	// Normally already untracked on exit tree, but SceneSaveload must never keep a dangling pointer.
+	// untrack() would have to cast this half-destroyed object, so the spawner list is updated directly.
+	SceneSaveload *saveload = Object::cast_to<SceneSaveload>(SaveloadAPI::get_singleton());
+	if (tracked_index != UNTRACKED && saveload) {
+		saveload->untrack_spawner(*this);
+	}
+}
+
 /***********************************
  * SaveloadSpawner Definitions End *
  ***********************************/
@@ -31,6 +31,7 @@
 #ifndef SAVELOAD_SPAWNER_H
 #define SAVELOAD_SPAWNER_H
 
+#include "saveload_path_table.h"
 #include "scene_saveload_config.h"
 
 #ifdef GDEXTENSION
@@ -54,38 +55,49 @@ using namespace godot;
 class SaveloadSpawner : public Node {
 	GDCLASS(SaveloadSpawner, Node);
 
+	friend class SceneSaveload;
+
 public:
 	enum {
 		CUSTOM_SPAWN = 0xFF,
 	};
 
+	enum : uint32_t {
+		UNTRACKED = UINT32_MAX,
+	};
+
 	struct SpawnInfo {
-		NodePath path;
+		uint32_t path_id = SaveloadPathTable::INVALID_ID;
 		int scene_index;
 		Variant spawn_args;
 
+		_FORCE_INLINE_ const NodePath &get_path() const { return SaveloadPathTable::get_singleton()->get_path(path_id); }
+
 		Dictionary to_dict() const;
 
-		SpawnInfo(NodePath p_path, int p_scene_index, Variant spawn_args);
+		SpawnInfo(uint32_t p_path_id, int p_scene_index, const Variant &p_spawn_args);
 		SpawnInfo(const Dictionary &p_dict);
 		SpawnInfo() {}
 	};
 
+	// A spawner's live state indexes its spawns by path. Snapshots and decoded states are
+	// filled through spawn_infos alone, as saving and loading only walk the spawns in order.
 	struct SpawnerState {
-		HashMap<const NodePath, int> tracked_paths;
+		HashMap<uint32_t, uint32_t> tracked_paths; // Path ID to index in spawn_infos.
 		LocalVector<SpawnInfo> spawn_infos;
 
 		_FORCE_INLINE_ uint32_t size() const { return spawn_infos.size(); }
 
-		void push_back(SpawnInfo p_spawn_info) {
+		void push_back(const SpawnInfo &p_spawn_info) {
 			spawn_infos.push_back(p_spawn_info);
-			tracked_paths.insert(p_spawn_info.path, spawn_infos.size() - 1);
+			tracked_paths.insert(p_spawn_info.path_id, spawn_infos.size() - 1);
 		}
-		bool has(const NodePath &p_path) const;
-		bool erase(const NodePath &p_path);
+		bool has(uint32_t p_path_id) const;
+		bool erase(uint32_t p_path_id);
 		void clear();
 
 		TypedArray<Dictionary> to_array() const;
+		void set_spawn_infos(const TypedArray<Dictionary> &p_array); // Leaves tracked_paths alone.
 
 		SpawnerState(const TypedArray<Dictionary> &p_array);
 		SpawnerState() {}
@@ -102,6 +114,8 @@ private:
 	NodePath spawn_path;
 
 	ObjectID spawn_parent_id;
+	uint32_t path_id = SaveloadPathTable::INVALID_ID; // Cached until the node leaves the tree or its path changes.
+	uint32_t tracked_index = UNTRACKED; // Index in SceneSaveload's spawner list.
 	SpawnerState spawner_state;
 	uint32_t spawn_limit = 0;
 	Callable spawn_function;
@@ -110,7 +124,7 @@ private:
 	Error _spawn(const String &p_name, int p_scene_index, const Variant &p_spawn_args = Variant());
 	void _track(Node *p_node, int p_scene_index, const Variant &p_spawn_args = Variant());
 	void _node_added(Node *p_node);
-	void _node_exit(const Node *p_id);
+	void _node_exit(uint32_t p_path_id);
 
     PackedStringArray _get_spawnable_scenes() const;
     void _set_spawnable_scenes(const PackedStringArray &p_scenes);
@@ -137,7 +151,9 @@ public:
 		return spawn_parent_id.is_valid() ? Object::cast_to<Node>(ObjectDB::get_instance(spawn_parent_id)) : nullptr;
 	}
 
-	SpawnerState get_spawner_state() const { return spawner_state; }
+	const SpawnerState &get_spawner_state() const { return spawner_state; }
+
+	uint32_t get_path_id();
 
 	void add_spawnable_scene(const String &p_path);
 	int get_spawnable_scene_count() const;
@@ -159,6 +175,7 @@ public:
 	Node *instantiate_scene(int p_idx);
 
 	SaveloadSpawner() {}
+	~SaveloadSpawner();
 };
 
 #endif // SAVELOAD_SPAWNER_H
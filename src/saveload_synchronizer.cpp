@@ -31,6 +31,7 @@
 #include "saveload_synchronizer.h"
 
 #include "saveload_api.h"
+#include "scene_saveload.h"
 #include "godot_cpp/classes/engine.hpp"
 
 Dictionary SaveloadSynchronizer::SyncherState::to_dict() const {
@@ -63,10 +64,8 @@ void SaveloadSynchronizer::_stop() {
 	}
 #endif
 	root_node_cache = ObjectID();
-	Node *node = is_inside_tree() ? get_node_or_null(root_path) : nullptr;
-	if (node) {
-		SaveloadAPI::get_singleton()->untrack(this);
-	}
+	// Untrack even if the root node is already gone, the tracker holds a pointer to this node.
+	SaveloadAPI::get_singleton()->untrack(this);
 }
 
 void SaveloadSynchronizer::_start() {
@@ -124,6 +123,99 @@ PackedStringArray SaveloadSynchronizer::get_configuration_warnings() const {
 }
 #endif
 
+const Object *SaveloadSynchronizer::get_property_object(const Node *p_root_node, const NodePath &p_property) {
+	if (p_property.get_name_count() == 0) {
+		return p_root_node;
+	}
+	ERR_FAIL_COND_V_MSG(!p_root_node->has_node(p_property), nullptr, vformat("Node '%s' not found.", p_property));
+#ifdef GDEXTENSION
+	return p_root_node->get_node<Object>(p_property);
+#elif
+	return p_root_node->get_node(p_property);
+#endif
+}
+
+bool SaveloadSynchronizer::has_indexed(const Object *p_object, const NodePath &p_property) {
+	if (p_property.get_subname_count() == 0) {
+		return true;
+	}
+#ifdef GDEXTENSION
+	// get_indexed() returns null for properties the object does not have, so the first subname
+	// is looked up in the property list and the rest in the values they index into.
+	const StringName name = p_property.get_subname(0);
+	const TypedArray<Dictionary> properties = p_object->get_property_list();
+	bool found = false;
+	for (int64_t i = 0; i < properties.size() && !found; i++) {
+		found = StringName(Dictionary(properties[i]).get("name", String())) == name;
+	}
+	Variant value = found ? p_object->get(name) : Variant();
+	for (int i = 1; i < p_property.get_subname_count() && found; i++) {
+		value = value.get_named(p_property.get_subname(i), found);
+	}
+	return found;
+#elif
+	bool valid = false;
+	p_object->get_indexed(p_property.get_subnames(), &valid);
+	return valid;
+#endif
+}
+
+bool SaveloadSynchronizer::read_indexed(const Object *p_object, const NodePath &p_property, bool p_exists, Variant &r_value) {
+#ifdef GDEXTENSION
+	r_value = p_object->get_indexed(NodePath(p_property.get_concatenated_subnames()));
+	ERR_FAIL_COND_V_MSG(r_value.get_type() == Variant::NIL && !p_exists, false, vformat("Property '%s' not found.", p_property));
+#elif
+	bool valid = false;
+	r_value = p_object->get_indexed(p_property.get_subnames(), &valid);
+	ERR_FAIL_COND_V_MSG(!valid, false, vformat("Property '%s' not found.", p_property));
+#endif
+	return true;
+}
+
+bool SaveloadSynchronizer::read_property(const Node *p_root_node, const NodePath &p_property, Variant &r_value) {
+	const Object *obj = get_property_object(p_root_node, p_property);
+	if (!obj) {
+		return false;
+	}
+	if (!read_indexed(obj, p_property, true, r_value)) {
+		return false;
+	}
+	// Only null values may come from a missing property, so only they pay for the lookup.
+	ERR_FAIL_COND_V_MSG(r_value.get_type() == Variant::NIL && !has_indexed(obj, p_property), false, vformat("Property '%s' not found.", p_property));
+	return true;
+}
+
+Object *SaveloadSynchronizer::get_property_node(Node *p_root_node, const NodePath &p_property) {
+	const NodePath node_path = NodePath(p_property.get_concatenated_names());
+	Node *node = p_root_node->get_node_or_null(node_path);
+	ERR_FAIL_COND_V_MSG(!node, nullptr, vformat("could not find node at %s", node_path));
+	return node;
+}
+
+bool SaveloadSynchronizer::write_indexed(Object *p_object, const NodePath &p_property, bool p_exists, const Variant &p_value) {
+#ifdef GDEXTENSION
+	ERR_FAIL_COND_V_MSG(!p_exists, false, vformat("Property '%s' not found.", p_property));
+	p_object->set_indexed(NodePath(p_property.get_concatenated_subnames()), p_value);
+#elif
+	bool valid = false;
+	p_object->set_indexed(p_property.get_subnames(), p_value, &valid);
+	ERR_FAIL_COND_V_MSG(!valid, false, vformat("Property '%s' not found.", p_property));
+#endif
+	return true;
+}
+
+bool SaveloadSynchronizer::write_property(Node *p_root_node, const NodePath &p_property, const Variant &p_value) {
+	Object *obj = get_property_node(p_root_node, p_property);
+	if (!obj) {
+		return false;
+	}
+#ifdef GDEXTENSION
+	return write_indexed(obj, p_property, has_indexed(obj, p_property), p_value);
+#elif
+	return write_indexed(obj, p_property, true, p_value);
+#endif
+}
+
 SaveloadSynchronizer::SyncherState SaveloadSynchronizer::get_syncher_state() const {
 	const List<NodePath> props = get_saveload_config()->get_sync_properties();
 	SyncherState sync_state;
@@ -131,44 +223,59 @@ SaveloadSynchronizer::SyncherState SaveloadSynchronizer::get_syncher_state() con
 	Node *root_node = get_root_node();
 	ERR_FAIL_COND_V_MSG(!root_node, sync_state, vformat("Could not find root node at %s.", get_root_path()));
 	for (const NodePath &prop : props) {
-		const Object *obj;
-		if (prop.get_name_count() == 0) {
-			obj = root_node;
-		} else {
-			ERR_CONTINUE_MSG(!root_node->has_node(prop), vformat("Node '%s' not found.", prop));
-#ifdef GDEXTENSION
-            obj = root_node->get_node<Object>(prop);
-#elif
-            obj = root_node->get_node(prop);
-#endif
+		Variant value;
+		if (read_property(root_node, prop, value)) {
+			sync_state.property_map.insert(prop, value);
 		}
-#ifdef GDEXTENSION
-        Variant value = obj->get_indexed(NodePath(prop.get_concatenated_subnames()));
-        // TODO: What if property isn't valid?
-#elif
-        bool valid = false;
-		Variant value = obj->get_indexed(prop.get_subnames(), &valid);
-        ERR_CONTINUE_MSG(!valid, vformat("Property '%s' not found.", prop));
-#endif
-		sync_state.property_map.insert(prop, value);
 	}
 	return sync_state;
 }
 
 Error SaveloadSynchronizer::set_syncher_state(const SaveloadSynchronizer::SyncherState &p_syncher_state) {
+	Node *root_node = get_root_node();
+	ERR_FAIL_COND_V_MSG(!root_node, ERR_UNCONFIGURED, vformat("Could not find root node at %s.", get_root_path()));
+	Error err = OK;
 	for (const KeyValue<const NodePath, Variant> &property : p_syncher_state.property_map) {
-		const NodePath path = property.key;
-		const NodePath node_path = NodePath(path.get_concatenated_names());
-		Node *node = get_root_node()->get_node_or_null(node_path);
-		ERR_CONTINUE_MSG(!node, vformat("could not find node at %s", node_path));
-#ifdef GDEXTENSION
-        node->set_indexed(NodePath(path.get_concatenated_subnames()), property.value);
-#elif
-		node->set_indexed(path.get_subnames(), property.value);
-#endif
-        // TODO: what if node doesn't have property?
+		if (!write_property(root_node, property.key, property.value)) {
+			err = ERR_INVALID_DATA;
+		}
+	}
+	return err;
+}
+
+bool SaveloadSynchronizer::is_disabled() const {
+	const Node *node = this;
+	while (node && node->get_process_mode() == PROCESS_MODE_INHERIT) {
+		node = node->get_parent();
+	}
+	return node && node->get_process_mode() == PROCESS_MODE_DISABLED;
+}
+
+void SaveloadSynchronizer::add_pending_property(const NodePath &p_property, const Variant &p_value) {
+	pending_properties.push_back(p_property);
+	pending_values.push_back(p_value);
+}
+
+void SaveloadSynchronizer::clear_pending_state() {
+	pending_properties.reset();
+	pending_values.reset();
+}
+
+bool SaveloadSynchronizer::has_pending_state() const {
+	return !pending_values.is_empty();
+}
+
+void SaveloadSynchronizer::apply_pending_state() {
+	if (pending_values.is_empty()) {
+		return;
+	}
+	Node *root_node = get_root_node();
+	ERR_FAIL_COND_MSG(!root_node, vformat("Could not find root node at %s.", get_root_path()));
+	for (uint32_t i = 0; i < pending_values.size(); i++) {
+		write_property(root_node, pending_properties[i], pending_values[i]);
 	}
-	return OK; // TODO: need to return a useful error
+	// Freed rather than emptied, as most synchronizers only ever hold one pending state.
+	clear_pending_state();
 }
 
 void SaveloadSynchronizer::_bind_methods() {
@@ -178,6 +285,9 @@ void SaveloadSynchronizer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_saveload_config", "config"), &SaveloadSynchronizer::set_saveload_config);
 	ClassDB::bind_method(D_METHOD("get_saveload_config"), &SaveloadSynchronizer::get_saveload_config);
 
+	ClassDB::bind_method(D_METHOD("has_pending_state"), &SaveloadSynchronizer::has_pending_state);
+	ClassDB::bind_method(D_METHOD("apply_pending_state"), &SaveloadSynchronizer::apply_pending_state);
+
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_path"), "set_root_path", "get_root_path");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "saveload_config", PROPERTY_HINT_RESOURCE_TYPE, "SceneSaveloadConfig", PROPERTY_USAGE_NO_EDITOR), "set_saveload_config", "get_saveload_config");
 
@@ -197,14 +307,33 @@ void SaveloadSynchronizer::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_ENTER_TREE: {
 			_start();
+			if (!pending_values.is_empty() && !is_disabled()) {
+				apply_pending_state();
+			}
+		} break;
+
+		case NOTIFICATION_ENABLED: {
+			apply_pending_state();
+		} break;
+
+		case NOTIFICATION_PATH_RENAMED: {
+			path_id = SaveloadPathTable::INVALID_ID;
 		} break;
 
 		case NOTIFICATION_EXIT_TREE: {
+			path_id = SaveloadPathTable::INVALID_ID;
 			_stop();
 		} break;
 	}
 }
 
+uint32_t SaveloadSynchronizer::get_path_id() {
+	if (path_id == SaveloadPathTable::INVALID_ID && is_inside_tree()) {
+		path_id = SaveloadPathTable::get_singleton()->intern(get_path());
+	}
+	return path_id;
+}
+
 void SaveloadSynchronizer::set_saveload_config(Ref<SceneSaveloadConfig> p_config) {
 	saveload_config = p_config;
 }
@@ -222,3 +351,11 @@ void SaveloadSynchronizer::set_root_path(const NodePath &p_path) {
 NodePath SaveloadSynchronizer::get_root_path() const {
 	return root_path;
 }
+
+SaveloadSynchronizer::~SaveloadSynchronizer() {
+	// untrack() would have to cast this half-destroyed object, so the synchronizer list is updated directly.
+	SceneSaveload *saveload = Object::cast_to<SceneSaveload>(SaveloadAPI::get_singleton());
+	if (tracked_index != UNTRACKED && saveload) {
+		saveload->untrack_syncher(*this);
+	}
+}
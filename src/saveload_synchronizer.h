@@ -31,6 +31,7 @@
 #ifndef SAVELOAD_SYNCHRONIZER_H
 #define SAVELOAD_SYNCHRONIZER_H
 
+#include "saveload_path_table.h"
 #include "scene_saveload_config.h"
 
 #ifdef GDEXTENSION
@@ -49,13 +50,19 @@ using namespace godot;
 class SaveloadSynchronizer : public Node {
     GDCLASS(SaveloadSynchronizer, Node);
 
+    friend class SceneSaveload;
+
 public:
+    enum : uint32_t {
+        UNTRACKED = UINT32_MAX,
+    };
+
     struct SyncherState {
         HashMap<const NodePath, Variant> property_map;
 
         Dictionary to_dict() const;
 
-        SyncherState(HashMap<const NodePath, Variant> p_property_map) { property_map = p_property_map; }
+        SyncherState(const HashMap<const NodePath, Variant> &p_property_map) { property_map = p_property_map; }
 
         SyncherState(const Dictionary &p_dict);
 
@@ -67,6 +74,18 @@ private:
     NodePath root_path = NodePath(".."); // Start with parent, like with AnimationPlayer.
 
     ObjectID root_node_cache;
+    uint32_t path_id = SaveloadPathTable::INVALID_ID; // Cached until the node leaves the tree or its path changes.
+    uint32_t tracked_index = UNTRACKED; // Index in SceneSaveload's synchronizer list.
+
+    // State kept by a lazy load, set once the synchronizer is enabled or re-enters the tree.
+    // Paths rather than path IDs, as they outlive the loads that set them and may be held while
+    // the synchronizer is out of the tree, where SceneSaveload does not keep their IDs alive.
+    LocalVector<NodePath> pending_properties;
+    LocalVector<Variant> pending_values;
+
+    // Keeps a value to be set once the synchronizer becomes relevant, for lazy loads.
+    void add_pending_property(const NodePath &p_property, const Variant &p_value);
+    void clear_pending_state();
 
     void _start();
 
@@ -80,10 +99,43 @@ protected:
     void _notification(int p_what);
 
 public:
+    // Resolves the object a property path points into, relative to the synchronizer's root node.
+    static const Object *get_property_object(const Node *p_root_node, const NodePath &p_property);
+
+    // Whether an object resolved by get_property_object() has every subname of p_property.
+    // GDExtension builds look the first one up in the property list, so only call it on the main thread.
+    static bool has_indexed(const Object *p_object, const NodePath &p_property);
+
+    // Reads the subname part of p_property from an object resolved by get_property_object().
+    // Does not touch the scene tree, so it may run off the main thread if the getter allows it.
+    // Returns false if the object has no such property, which saves record as missing. GDExtension
+    // builds cannot tell a null value from a missing property, so they take p_exists from has_indexed().
+    static bool read_indexed(const Object *p_object, const NodePath &p_property, bool p_exists, Variant &r_value);
+
+    static bool read_property(const Node *p_root_node, const NodePath &p_property, Variant &r_value);
+
+    // Resolves the node a property path is set on, relative to the synchronizer's root node.
+    static Object *get_property_node(Node *p_root_node, const NodePath &p_property);
+
+    // Sets the subname part of p_property on an object resolved by get_property_node().
+    // Returns false if the object has no such property. GDExtension builds' set_indexed() ignores
+    // missing properties, so they take p_exists from has_indexed() and module builds ignore it.
+    static bool write_indexed(Object *p_object, const NodePath &p_property, bool p_exists, const Variant &p_value);
+
+    static bool write_property(Node *p_root_node, const NodePath &p_property, const Variant &p_value);
+
     SyncherState get_syncher_state() const;
 
     Error set_syncher_state(const SyncherState &p_syncher_state);
 
+    // Whether the synchronizer is disabled by its own process mode or the one it inherits.
+    bool is_disabled() const;
+
+    bool has_pending_state() const;
+
+    // Sets the state a lazy load kept for this synchronizer, if any.
+    void apply_pending_state();
+
 #ifdef GDEXTENSION
     PackedStringArray _get_configuration_warnings() const override;
 #elif
@@ -96,11 +148,15 @@ public:
 
     Node *get_root_node() const;
 
+    uint32_t get_path_id();
+
     void set_root_path(const NodePath &p_path);
 
     NodePath get_root_path() const;
 
     SaveloadSynchronizer() {}
+
+    ~SaveloadSynchronizer();
 };
 
 #endif // SAVELOAD_SYNCHRONIZER_H
@@ -29,8 +29,12 @@
 /**************************************************************************/
 
 #include <stdint.h>
+#include <chrono>
 
 #include "scene_saveload.h"
+#include "saveload_chunk_store.h"
+#include "saveload_encoder.h"
+#include "saveload_file_writer.h"
 
 #ifdef GDEXTENSION
 
@@ -39,6 +43,9 @@
 #include <godot_cpp/classes/marshalls.hpp>
 #include <godot_cpp/classes/scene_tree.hpp>
 #include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 
 #ifdef DEBUG_ENABLED
 #include <godot_cpp/classes/os.hpp>
@@ -51,6 +58,10 @@ using namespace godot;
 #include "core/debugger/engine_debugger.h"
 #include "core/io/file_access.h"
 #include "core/io/marshalls.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/time.h"
+#include "main/performance.h"
+#include "scene/main/scene_tree.h"
 
 #ifdef DEBUG_ENABLED
 #include "core/os/os.h"
@@ -58,6 +69,296 @@ using namespace godot;
 
 #endif
 
+const char *SceneSaveload::phase_names[PHASE_MAX] = {
+	"snapshot",
+	"encode",
+	"compress",
+	"encrypt",
+	"write",
+	"read",
+	"decode",
+	"spawn",
+	"apply",
+};
+
+// Monitors past the phases, in the order _get_monitor_value() reports them.
+static const char *extra_monitor_names[] = {
+	"total",
+	"bytes",
+	"spawners",
+	"spawned_nodes",
+	"synchronizers",
+	"properties",
+};
+
+uint64_t SceneSaveload::get_ticks_usec() {
+	return Time::get_singleton()->get_ticks_usec();
+}
+
+uint64_t SceneSaveload::get_ticks_nsec() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Variant SceneSaveload::_get_option(const Variant &p_configuration_data, const String &p_key, const Variant &p_default) {
+	if (p_configuration_data.get_type() != Variant::DICTIONARY) {
+		return p_default;
+	}
+	const Dictionary options = p_configuration_data;
+	return options.get(p_key, p_default);
+}
+
+void SceneSaveload::OperationStats::reset(const String &p_operation) {
+	*this = OperationStats();
+	operation = p_operation;
+}
+
+Dictionary SceneSaveload::OperationStats::to_dict() const {
+	Dictionary dict;
+	dict[StringName("operation")] = operation;
+	Dictionary phases;
+	for (int i = 0; i < PHASE_MAX; i++) {
+		phases[StringName(phase_names[i])] = phase_usec[i];
+	}
+	dict[StringName("phase_usec")] = phases;
+	dict[StringName("total_usec")] = total_usec;
+	dict[StringName("spawners")] = spawner_count;
+	dict[StringName("spawned_nodes")] = spawn_count;
+	dict[StringName("synchronizers")] = syncher_count;
+	dict[StringName("properties")] = property_count;
+	dict[StringName("bytes")] = byte_count;
+	dict[StringName("retained_bytes")] = retained_bytes;
+	dict[StringName("scratch_allocations")] = scratch_allocations;
+	return dict;
+}
+
+SceneSaveload::PhaseTimer::PhaseTimer(SceneSaveload *p_saveload, Phase p_phase) {
+	phase = p_phase;
+	if (p_saveload && p_saveload->instrumentation_enabled) {
+		stats = &p_saveload->last_operation_stats;
+		start = get_ticks_usec();
+	}
+}
+
+SceneSaveload::PhaseTimer::~PhaseTimer() {
+	if (stats) {
+		stats->phase_usec[phase] += get_ticks_usec() - start;
+	}
+}
+
+SceneSaveload::MemoryProbe::MemoryProbe(SceneSaveload *p_saveload) {
+#ifdef DEBUG_ENABLED
+	if (p_saveload && p_saveload->instrumentation_enabled) {
+		stats = &p_saveload->last_operation_stats;
+		start = OS::get_singleton()->get_static_memory_usage();
+	}
+#endif
+}
+
+SceneSaveload::MemoryProbe::~MemoryProbe() {
+#ifdef DEBUG_ENABLED
+	if (stats) {
+		stats->retained_bytes = int64_t(OS::get_singleton()->get_static_memory_usage()) - int64_t(start);
+	}
+#endif
+}
+
+void SceneSaveload::_begin_operation(const String &p_operation) {
+	if (instrumentation_enabled) {
+		last_operation_stats.reset(p_operation);
+	}
+}
+
+void SceneSaveload::_end_operation(uint64_t p_start_usec) {
+	if (instrumentation_enabled) {
+		last_operation_stats.total_usec = get_ticks_usec() - p_start_usec;
+	}
+}
+
+void SceneSaveload::_count_state(const SaveloadState &p_saveload_state) {
+	if (!instrumentation_enabled) {
+		return;
+	}
+	last_operation_stats.spawner_count = p_saveload_state.spawner_states.size();
+	for (const KeyValue<uint32_t, SaveloadSpawner::SpawnerState> &spawner_state : p_saveload_state.spawner_states) {
+		last_operation_stats.spawn_count += spawner_state.value.size();
+	}
+	for (const SyncherGroup &group : p_saveload_state.syncher_groups) {
+		last_operation_stats.syncher_count += group.synchers.size();
+		last_operation_stats.property_count += group.synchers.size() * group.properties.size();
+	}
+}
+
+void SceneSaveload::_add_monitors() {
+	Performance *performance = Performance::get_singleton();
+	ERR_FAIL_NULL(performance);
+	const int monitor_count = PHASE_MAX + sizeof(extra_monitor_names) / sizeof(extra_monitor_names[0]);
+	for (int i = 0; i < monitor_count; i++) {
+		const String name = i < PHASE_MAX ? String(phase_names[i]) + "_usec" : String(extra_monitor_names[i - PHASE_MAX]);
+		const StringName id = StringName("saveload/" + name);
+		if (!performance->has_custom_monitor(id)) {
+			performance->add_custom_monitor(id, callable_mp(this, &SceneSaveload::_get_monitor_value).bind(i));
+		}
+	}
+}
+
+void SceneSaveload::_remove_monitors() {
+	Performance *performance = Performance::get_singleton();
+	if (!performance) {
+		return;
+	}
+	const int monitor_count = PHASE_MAX + sizeof(extra_monitor_names) / sizeof(extra_monitor_names[0]);
+	for (int i = 0; i < monitor_count; i++) {
+		const String name = i < PHASE_MAX ? String(phase_names[i]) + "_usec" : String(extra_monitor_names[i - PHASE_MAX]);
+		const StringName id = StringName("saveload/" + name);
+		if (performance->has_custom_monitor(id)) {
+			performance->remove_custom_monitor(id);
+		}
+	}
+}
+
+Variant SceneSaveload::_get_monitor_value(int p_monitor) const {
+	if (p_monitor < PHASE_MAX) {
+		return last_operation_stats.phase_usec[p_monitor];
+	}
+	switch (p_monitor - PHASE_MAX) {
+		case 0:
+			return last_operation_stats.total_usec;
+		case 1:
+			return last_operation_stats.byte_count;
+		case 2:
+			return last_operation_stats.spawner_count;
+		case 3:
+			return last_operation_stats.spawn_count;
+		case 4:
+			return last_operation_stats.syncher_count;
+		case 5:
+			return last_operation_stats.property_count;
+	}
+	return 0;
+}
+
+void SceneSaveload::set_instrumentation_enabled(bool p_enabled) {
+	if (instrumentation_enabled == p_enabled) {
+		return;
+	}
+	instrumentation_enabled = p_enabled;
+	if (instrumentation_enabled) {
+		_add_monitors();
+	} else {
+		_remove_monitors();
+	}
+}
+
+bool SceneSaveload::is_instrumentation_enabled() const {
+	return instrumentation_enabled;
+}
+
+Dictionary SceneSaveload::get_last_operation_stats() const {
+	return last_operation_stats.to_dict();
+}
+
+void SceneSaveload::CostReport::clear() {
+	synchers.clear();
+	configs.clear();
+	properties.clear();
+}
+
+String SceneSaveload::_get_config_name(const Ref<SceneSaveloadConfig> &p_config) {
+	if (p_config.is_null()) {
+		return String();
+	}
+	const String path = p_config->get_path();
+	return path.is_empty() ? vformat("SceneSaveloadConfig:%s", p_config->get_instance_id()) : path;
+}
+
+Array SceneSaveload::_sorted_costs(const HashMap<String, CostEntry> &p_entries, int p_top_n, bool p_by_time) {
+	LocalVector<CostEntry> entries;
+	entries.reserve(p_entries.size());
+	for (const KeyValue<String, CostEntry> &entry : p_entries) {
+		entries.push_back(entry.value);
+	}
+	if (p_by_time) {
+		entries.sort_custom<CostEntryByTime>();
+	} else {
+		entries.sort_custom<CostEntryByBytes>();
+	}
+	const uint32_t count = p_top_n < 0 ? entries.size() : MIN((uint32_t)p_top_n, entries.size());
+	Array report;
+	report.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		Dictionary dict;
+		dict[StringName("name")] = entries[i].name;
+		dict[StringName("config")] = entries[i].config;
+		dict[StringName("bytes")] = entries[i].bytes;
+		dict[StringName("usec")] = entries[i].nsec / 1000.0;
+		dict[StringName("nsec")] = entries[i].nsec;
+		dict[StringName("count")] = entries[i].count;
+		report[i] = dict;
+	}
+	return report;
+}
+
+void SceneSaveload::_record_costs(const SyncherGroup &p_group, uint32_t p_instance, const LocalVector<uint64_t> &p_property_nsec, uint64_t p_syncher_nsec) {
+	const String config_name = _get_config_name(p_group.config);
+	const NodePath &syncher_path = path_table.get_path(p_group.synchers[p_instance]);
+	// Sizes are measured as the values would be encoded on their own, key included.
+	uint64_t syncher_bytes = SaveloadEncoder::encode_variant(syncher_path).size();
+	for (uint32_t i = 0; i < p_group.properties.size(); i++) {
+		const NodePath &property = path_table.get_path(p_group.properties[i]);
+		const uint64_t bytes = SaveloadEncoder::encode_variant(property).size() + SaveloadEncoder::encode_variant(p_group.columns[i][p_instance]).size();
+		const String key = config_name + "::" + String(property);
+		if (!cost_report.properties.has(key)) {
+			CostEntry entry;
+			entry.name = property;
+			entry.config = config_name;
+			cost_report.properties.insert(key, entry);
+		}
+		CostEntry &entry = cost_report.properties[key];
+		entry.bytes += bytes;
+		entry.nsec += p_property_nsec[i];
+		entry.count++;
+		syncher_bytes += bytes;
+	}
+
+	CostEntry syncher_entry;
+	syncher_entry.name = syncher_path;
+	syncher_entry.config = config_name;
+	syncher_entry.bytes = syncher_bytes;
+	syncher_entry.nsec = p_syncher_nsec;
+	syncher_entry.count = 1;
+	cost_report.synchers.insert(syncher_entry.name, syncher_entry);
+
+	if (!cost_report.configs.has(config_name)) {
+		CostEntry entry;
+		entry.name = config_name;
+		entry.config = config_name;
+		cost_report.configs.insert(config_name, entry);
+	}
+	CostEntry &config_entry = cost_report.configs[config_name];
+	config_entry.bytes += syncher_bytes;
+	config_entry.nsec += p_syncher_nsec;
+	config_entry.count++;
+}
+
+void SceneSaveload::set_cost_diagnostics_enabled(bool p_enabled) {
+	cost_diagnostics_enabled = p_enabled;
+	if (!cost_diagnostics_enabled) {
+		cost_report.clear();
+	}
+}
+
+bool SceneSaveload::is_cost_diagnostics_enabled() const {
+	return cost_diagnostics_enabled;
+}
+
+Dictionary SceneSaveload::get_cost_report(int p_top_n, bool p_sort_by_time) const {
+	Dictionary report;
+	report[StringName("synchronizers")] = _sorted_costs(cost_report.synchers, p_top_n, p_sort_by_time);
+	report[StringName("configs")] = _sorted_costs(cost_report.configs, p_top_n, p_sort_by_time);
+	report[StringName("properties")] = _sorted_costs(cost_report.properties, p_top_n, p_sort_by_time);
+	return report;
+}
+
 template <class T>
 T *SceneSaveload::get_node(const NodePath &p_path) {
 #ifdef GDEXTENSION
@@ -73,22 +374,35 @@ T *SceneSaveload::get_node(const NodePath &p_path) {
 #endif
 }
 
+void SceneSaveload::add_migration(const Callable &p_migration) {
+	ERR_FAIL_COND(!p_migration.is_valid());
+	migrations.push_back(p_migration);
+}
+
+void SceneSaveload::remove_migration(const Callable &p_migration) {
+	migrations.erase(p_migration);
+}
+
+void SceneSaveload::apply_pending_states() {
+	for (SaveloadSynchronizer *sync : synchers) {
+		sync->apply_pending_state();
+	}
+}
+
 TypedArray<SaveloadSpawner> SceneSaveload::get_spawners() const {
-	TypedArray<SaveloadSynchronizer> spawner_array;
-	for (const ID &oid : spawners) {
-		SaveloadSpawner *spawner = get_id_as<SaveloadSpawner>(oid);
-		ERR_CONTINUE_MSG(!spawner, vformat("%s is not a valid SaveloadSpawner", oid));
-		spawner_array.append(spawner);
+	TypedArray<SaveloadSpawner> spawner_array;
+	spawner_array.resize(spawners.size());
+	for (uint32_t i = 0; i < spawners.size(); i++) {
+		spawner_array[i] = spawners[i];
 	}
 	return spawner_array;
 }
 
 TypedArray<SaveloadSynchronizer> SceneSaveload::get_synchers() const {
 	TypedArray<SaveloadSynchronizer> sync_array;
-	for (const ID &oid : synchers) {
-		SaveloadSynchronizer *sync = get_id_as<SaveloadSynchronizer>(oid);
-		ERR_CONTINUE_MSG(!sync, vformat("%s is not a valid SaveloadSynchronizer", oid));
-		sync_array.append(sync);
+	sync_array.resize(synchers.size());
+	for (uint32_t i = 0; i < synchers.size(); i++) {
+		sync_array[i] = synchers[i];
 	}
 	return sync_array;
 }
@@ -121,145 +435,1314 @@ Error SceneSaveload::untrack(Object *p_object) {
 	}
 }
 
-void SceneSaveload::track_spawner(const SaveloadSpawner &p_spawner) {
-	const ID spawner_id = p_spawner.get_instance_id();
-	if (!spawners.has(spawner_id)) {
-		spawners.insert(spawner_id);
+void SceneSaveload::track_spawner(SaveloadSpawner &p_spawner) {
+	if (p_spawner.tracked_index != SaveloadSpawner::UNTRACKED) {
+		return;
 	}
+	p_spawner.tracked_index = spawners.size();
+	spawners.push_back(&p_spawner);
 }
 
-void SceneSaveload::untrack_spawner(const SaveloadSpawner &p_spawner) {
-	spawners.erase(p_spawner.get_instance_id());
+void SceneSaveload::untrack_spawner(SaveloadSpawner &p_spawner) {
+	const uint32_t index = p_spawner.tracked_index;
+	if (index == SaveloadSpawner::UNTRACKED) {
+		return;
+	}
+	ERR_FAIL_COND(index >= spawners.size() || spawners[index] != &p_spawner);
+	spawners[index] = spawners[spawners.size() - 1];
+	spawners[index]->tracked_index = index;
+	spawners.resize(spawners.size() - 1);
+	p_spawner.tracked_index = SaveloadSpawner::UNTRACKED;
+	// Untracked nodes are not marked, so they must not keep an ID a collection could free.
+	p_spawner.path_id = SaveloadPathTable::INVALID_ID;
+	_collect_paths();
 }
 
-void SceneSaveload::track_syncher(const SaveloadSynchronizer &p_syncher) {
-	const ID syncher_id = p_syncher.get_instance_id();
-	if (!synchers.has(syncher_id)) {
-		synchers.insert(syncher_id);
+void SceneSaveload::track_syncher(SaveloadSynchronizer &p_syncher) {
+	if (p_syncher.tracked_index != SaveloadSynchronizer::UNTRACKED) {
+		return;
 	}
+	p_syncher.tracked_index = synchers.size();
+	synchers.push_back(&p_syncher);
 }
 
-void SceneSaveload::untrack_syncher(const SaveloadSynchronizer &p_syncher) {
-	synchers.erase(p_syncher.get_instance_id());
+void SceneSaveload::untrack_syncher(SaveloadSynchronizer &p_syncher) {
+	const uint32_t index = p_syncher.tracked_index;
+	if (index == SaveloadSynchronizer::UNTRACKED) {
+		return;
+	}
+	ERR_FAIL_COND(index >= synchers.size() || synchers[index] != &p_syncher);
+	synchers[index] = synchers[synchers.size() - 1];
+	synchers[index]->tracked_index = index;
+	synchers.resize(synchers.size() - 1);
+	p_syncher.tracked_index = SaveloadSynchronizer::UNTRACKED;
+	p_syncher.path_id = SaveloadPathTable::INVALID_ID;
+	_collect_paths();
 }
 
-SceneSaveload::SaveloadState SceneSaveload::get_saveload_state() const {
-	SaveloadState saveload_state;
-	for (const ID &oid : spawners) {
-		SaveloadSpawner *spawner = get_id_as<SaveloadSpawner>(oid);
-		ERR_CONTINUE_MSG(!spawner, vformat("%s is not a valid SaveloadSpawner", oid));
-		SaveloadSpawner::SpawnerState spawn_state = spawner->get_spawner_state();
-		saveload_state.spawner_states.insert(spawner->get_path(), spawn_state);
-	}
-	for (const ID &oid : synchers) {
-		SaveloadSynchronizer *sync = get_id_as<SaveloadSynchronizer>(oid);
-		ERR_CONTINUE_MSG(!sync, vformat("%s is not a valid SaveloadSynchronizer", oid));
-		SaveloadSynchronizer::SyncherState sync_state = sync->get_syncher_state();
-		saveload_state.syncher_states.insert(sync->get_path(), sync_state);
+SceneSaveload::PathHold::PathHold(SceneSaveload *p_saveload) {
+	saveload = p_saveload;
+	saveload->path_holds++;
+}
+
+SceneSaveload::PathHold::~PathHold() {
+	saveload->path_holds--;
+	saveload->_collect_paths();
+}
+
+void SceneSaveload::_mark_paths(SaveloadPathTable &r_paths, const SaveloadState &p_saveload_state) {
+	for (const KeyValue<uint32_t, SaveloadSpawner::SpawnerState> &spawner_state : p_saveload_state.spawner_states) {
+		r_paths.mark(spawner_state.key);
+		for (const SaveloadSpawner::SpawnInfo &spawn_info : spawner_state.value.spawn_infos) {
+			r_paths.mark(spawn_info.path_id);
+		}
+	}
+	for (const SyncherGroup &group : p_saveload_state.syncher_groups) {
+		for (const uint32_t property : group.properties) {
+			r_paths.mark(property);
+		}
+		for (const uint32_t syncher : group.synchers) {
+			r_paths.mark(syncher);
+		}
+	}
+}
+
+void SceneSaveload::_collect_paths() {
+	if (path_holds || !path_table.needs_collect()) {
+		return;
+	}
+	for (const SaveloadSpawner *spawner : spawners) {
+		path_table.mark(spawner->path_id);
+		// Tracked spawns are keyed by the same IDs, including the ones bound to their exit callbacks.
+		for (const SaveloadSpawner::SpawnInfo &spawn_info : spawner->spawner_state.spawn_infos) {
+			path_table.mark(spawn_info.path_id);
+		}
+	}
+	for (const SaveloadSynchronizer *sync : synchers) {
+		path_table.mark(sync->path_id);
+	}
+	for (const SortEntry &entry : spawner_sort_entries) {
+		path_table.mark(entry.path_id);
+	}
+	for (const SortEntry &entry : syncher_sort_entries) {
+		path_table.mark(entry.path_id);
+	}
+	_mark_paths(path_table, save_state);
+	path_table.sweep();
+}
+
+template <typename T>
+uint32_t SceneSaveload::_sort_by_path(LocalVector<T *> &r_nodes, LocalVector<SortEntry> &r_entries, SaveloadPathTable &r_paths) {
+	// Nodes are only moved by tracking, untracking and sorting, so while each holds the entry it
+	// was sorted with and the same path ID, they are still in order.
+	bool sorted = r_entries.size() == r_nodes.size();
+	for (uint32_t i = 0; i < r_nodes.size() && sorted; i++) {
+		sorted = r_entries[i].node == r_nodes[i] && r_entries[i].path_id == r_nodes[i]->get_path_id();
+	}
+	if (sorted) {
+		return 0;
+	}
+	// The entries are refilled in place, and only rebuild the keys of paths they do not hold yet.
+	uint32_t built = r_entries.size() < r_nodes.size() ? 1 : 0;
+	r_entries.resize(r_nodes.size());
+	for (uint32_t i = 0; i < r_nodes.size(); i++) {
+		SortEntry &entry = r_entries[i];
+		const uint32_t path_id = r_nodes[i]->get_path_id();
+		if (entry.path_id != path_id) {
+			entry.path = r_paths.is_valid(path_id) ? String(r_paths.get_path(path_id)) : String();
+			entry.path_id = path_id;
+			built++;
+		}
+		entry.node = r_nodes[i];
+	}
+	r_entries.sort();
+	for (uint32_t i = 0; i < r_entries.size(); i++) {
+		r_nodes[i] = (T *)r_entries[i].node;
+		r_nodes[i]->tracked_index = i;
+	}
+	return built;
+}
+
+void SceneSaveload::_sort_tracked() {
+	const uint32_t built = _sort_by_path(spawners, spawner_sort_entries, path_table) + _sort_by_path(synchers, syncher_sort_entries, path_table);
+	if (instrumentation_enabled) {
+		last_operation_stats.scratch_allocations += built;
 	}
+}
+
+#ifndef GDEXTENSION
+struct GroupTaskData {
+	SceneSaveload *saveload;
+	void (SceneSaveload::*method)(uint32_t);
+};
+
+static void _group_task_native(void *p_userdata, uint32_t p_index) {
+	GroupTaskData *data = (GroupTaskData *)p_userdata;
+	(data->saveload->*data->method)(p_index);
+}
+#endif
+
+void SceneSaveload::_run_group_task(void (SceneSaveload::*p_method)(uint32_t), uint32_t p_elements, const String &p_description) {
+	if (!p_elements) {
+		return;
+	}
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+#ifdef GDEXTENSION
+	const int64_t group_id = pool->add_group_task(callable_mp(this, p_method), p_elements, -1, true, p_description);
+#elif
+	GroupTaskData data = { this, p_method };
+	const WorkerThreadPool::GroupID group_id = pool->add_native_group_task(&_group_task_native, &data, p_elements, -1, true, p_description);
+#endif
+	pool->wait_for_group_task_completion(group_id);
+}
+
+void SceneSaveload::CaptureJob::clear() {
+	state = nullptr;
+	// Per-group vectors are emptied rather than freed, so the next capture can reuse them.
+	for (LocalVector<uint32_t> &group_properties : properties) {
+		group_properties.clear();
+	}
+	for (LocalVector<LocalVector<const Object *>> &group_targets : targets) {
+		for (LocalVector<const Object *> &property_targets : group_targets) {
+			property_targets.clear();
+		}
+	}
+	batches.clear();
+}
+
+void SceneSaveload::_capture_batch(uint32_t p_batch) {
+	const TaskBatch &batch = capture_job.batches[p_batch];
+	SyncherGroup &group = capture_job.state->syncher_groups[batch.group];
+	const LocalVector<uint32_t> &properties = capture_job.properties[batch.group];
+	const LocalVector<uint8_t> &exists = capture_property_exists[batch.group];
+	for (uint32_t i = 0; i < properties.size(); i++) {
+		const NodePath &property = path_table.get_path(group.properties[properties[i]]);
+		const LocalVector<const Object *> &targets = capture_job.targets[batch.group][i];
+		LocalVector<Variant> &column = group.columns[properties[i]];
+		// Each task sets the flags of its own synchronizers, which the main thread sized beforehand.
+		LocalVector<uint8_t> &missing = group.missing[properties[i]];
+		for (uint32_t instance = batch.begin; instance < batch.end; instance++) {
+			missing[instance] = !targets[instance] || !SaveloadSynchronizer::read_indexed(targets[instance], property, exists[properties[i]], column[instance]);
+		}
+	}
+}
+
+void SceneSaveload::_begin_capture_group(SyncherGroup &r_group, const Ref<SceneSaveloadConfig> &p_config, const Node *p_root_node, uint32_t p_group_index, bool p_threaded, SceneSaveloadConfig::SaveTier p_tier) {
+	r_group.config = p_config;
+	r_group.fingerprint = p_config->get_schema_fingerprint();
+	capture_properties.clear();
+	capture_thread_safe.clear();
+	// Properties of a higher tier than the save are left out, and keep their values on load.
+	for (const NodePath &property : p_config->get_sync_properties()) {
+		if (p_config->property_get_tier(property) > p_tier) {
+			continue;
+		}
+		capture_properties.push_back(path_table.intern(property));
+		capture_thread_safe.push_back(p_config->property_get_thread_safe(property));
+	}
+	bool same_properties = capture_properties.size() == r_group.properties.size();
+	for (uint32_t i = 0; i < capture_properties.size() && same_properties; i++) {
+		same_properties = capture_properties[i] == r_group.properties[i] && capture_thread_safe[i] == r_group.thread_safe[i];
+	}
+	if (!same_properties) {
+		r_group.properties = capture_properties;
+		r_group.thread_safe = capture_thread_safe;
+		r_group.columns.resize(r_group.properties.size());
+	}
+	r_group.missing.resize(r_group.properties.size());
+	// GDExtension builds can only tell a null value from a missing property by scanning the property
+	// list, which is neither cheap nor safe on worker threads, so each property is looked up once per
+	// capture, on the group's first synchronizer, and its other synchronizers are taken to match.
+	if (p_group_index >= capture_property_exists.size()) {
+		capture_property_exists.resize(p_group_index + 1);
+	}
+	LocalVector<uint8_t> &exists = capture_property_exists[p_group_index];
+	exists.resize(r_group.properties.size());
+	for (uint32_t i = 0; i < r_group.properties.size(); i++) {
+		const NodePath &property = path_table.get_path(r_group.properties[i]);
+		// Objects that cannot be found are reported when their synchronizers are read.
+		const Object *object = property.get_name_count() == 0 || p_root_node->has_node(property) ? SaveloadSynchronizer::get_property_object(p_root_node, property) : nullptr;
+		exists[i] = !object || SaveloadSynchronizer::has_indexed(object, property);
+	}
+	if (!p_threaded) {
+		return;
+	}
+	if (p_group_index >= capture_job.properties.size()) {
+		capture_job.properties.resize(p_group_index + 1);
+		capture_job.targets.resize(p_group_index + 1);
+	}
+	LocalVector<uint32_t> &task_properties = capture_job.properties[p_group_index];
+	for (uint32_t i = 0; i < r_group.properties.size(); i++) {
+		if (r_group.thread_safe[i]) {
+			task_properties.push_back(i);
+		}
+	}
+	capture_job.targets[p_group_index].resize(task_properties.size());
+}
+
+SceneSaveload::SaveloadState SceneSaveload::get_saveload_state(bool p_threaded, SceneSaveloadConfig::SaveTier p_tier) {
+	SaveloadState saveload_state;
+	get_saveload_state(saveload_state, p_threaded, p_tier);
 	return saveload_state;
 }
 
-Error SceneSaveload::load_saveload_state(const SaveloadState &p_saveload_state) {
-	for (const KeyValue<const NodePath, SaveloadSpawner::SpawnerState> &spawner_state : p_saveload_state.spawner_states) {
-		SaveloadSpawner *spawner_node = get_node<SaveloadSpawner>(spawner_state.key);
-		ERR_CONTINUE_MSG(!spawner_node, vformat("could not find SaveloadSpawner at path %s", spawner_state.key));
-		spawner_node->load_spawn_state(spawner_state.value);
+void SceneSaveload::get_saveload_state(SaveloadState &r_saveload_state, bool p_threaded, SceneSaveloadConfig::SaveTier p_tier) {
+	if (cost_diagnostics_enabled) {
+		cost_report.clear();
+	}
+	r_saveload_state.spawner_states.clear();
+	for (SaveloadSpawner *spawner : spawners) {
+		// Only the spawns are copied, straight into the state's own entry.
+		SaveloadSpawner::SpawnerState &spawn_state = r_saveload_state.spawner_states.insert(spawner->get_path_id(), SaveloadSpawner::SpawnerState())->value;
+		spawn_state.spawn_infos = spawner->get_spawner_state().spawn_infos;
+	}
+	// Groups left in the state by an earlier capture are refilled rather than rebuilt, so their
+	// columns keep the memory they grew to.
+	for (SyncherGroup &group : r_saveload_state.syncher_groups) {
+		group.synchers.clear();
+		for (LocalVector<Variant> &column : group.columns) {
+			column.clear();
+		}
+		for (LocalVector<uint8_t> &flags : group.missing) {
+			flags.clear();
+		}
+	}
+	// Cost diagnostics time each read on its own, so they always capture serially.
+	const bool threaded = p_threaded && !cost_diagnostics_enabled;
+	if (threaded) {
+		capture_job.clear();
+		capture_job.state = &r_saveload_state;
+	}
+	capture_group_order.clear();
+	// Values still pending from a lazy load are newer than what their nodes hold. They are captured
+	// in place of the values read, without being set, once any threaded reads are done.
+	struct PendingCapture {
+		uint32_t group;
+		uint32_t instance;
+		const SaveloadSynchronizer *sync;
+	};
+	LocalVector<PendingCapture> pending_captures;
+	LocalVector<uint64_t> &property_nsec = capture_property_nsec;
+	for (SaveloadSynchronizer *sync : synchers) {
+		const Ref<SceneSaveloadConfig> config = sync->get_saveload_config();
+		ERR_CONTINUE_MSG(config.is_null(), vformat("SaveloadSynchronizer %s has no SceneSaveloadConfig", sync->get_path()));
+		const Node *root_node = sync->get_root_node();
+		ERR_CONTINUE_MSG(!root_node, vformat("Could not find root node at %s.", sync->get_root_path()));
+
+		const uint64_t config_id = config->get_instance_id();
+		HashMap<uint64_t, uint32_t>::Iterator group_index = r_saveload_state.config_groups.find(config_id);
+		if (!group_index) {
+			r_saveload_state.syncher_groups.push_back(SyncherGroup());
+			group_index = r_saveload_state.config_groups.insert(config_id, r_saveload_state.syncher_groups.size() - 1);
+		}
+		SyncherGroup &group = r_saveload_state.syncher_groups[group_index->value];
+		if (group.synchers.is_empty()) {
+			_begin_capture_group(group, config, root_node, group_index->value, threaded, p_tier);
+			capture_group_order.push_back(group_index->value);
+		}
+		const uint64_t start = cost_diagnostics_enabled ? get_ticks_nsec() : 0;
+		const uint32_t instance = group.add_syncher(sync->get_path_id());
+		property_nsec.resize(group.properties.size());
+		const LocalVector<uint8_t> &exists = capture_property_exists[group_index->value];
+		for (uint32_t i = 0; i < group.properties.size(); i++) {
+			if (threaded && group.thread_safe[i]) {
+				continue;
+			}
+			const uint64_t property_start = cost_diagnostics_enabled ? get_ticks_nsec() : 0;
+			const NodePath &property = path_table.get_path(group.properties[i]);
+			const Object *object = SaveloadSynchronizer::get_property_object(root_node, property);
+			group.missing[i][instance] = !object || !SaveloadSynchronizer::read_indexed(object, property, exists[i], group.columns[i][instance]);
+			if (cost_diagnostics_enabled) {
+				property_nsec[i] = get_ticks_nsec() - property_start;
+			}
+		}
+		if (threaded) {
+			const LocalVector<uint32_t> &task_properties = capture_job.properties[group_index->value];
+			for (uint32_t i = 0; i < task_properties.size(); i++) {
+				const NodePath &property = path_table.get_path(group.properties[task_properties[i]]);
+				capture_job.targets[group_index->value][i].push_back(SaveloadSynchronizer::get_property_object(root_node, property));
+			}
+		}
+		if (cost_diagnostics_enabled) {
+			_record_costs(group, instance, property_nsec, get_ticks_nsec() - start);
+		}
+		if (sync->has_pending_state()) {
+			pending_captures.push_back({ group_index->value, instance, sync });
+		}
+	}
+	if (threaded) {
+		for (const uint32_t i : capture_group_order) {
+			if (capture_job.properties[i].is_empty()) {
+				continue;
+			}
+			const uint32_t instance_count = r_saveload_state.syncher_groups[i].synchers.size();
+			for (uint32_t begin = 0; begin < instance_count; begin += TASK_BATCH_SIZE) {
+				TaskBatch batch;
+				batch.group = i;
+				batch.begin = begin;
+				batch.end = MIN(begin + TASK_BATCH_SIZE, instance_count);
+				capture_job.batches.push_back(batch);
+			}
+		}
+		_run_group_task(&SceneSaveload::_capture_batch, capture_job.batches.size(), "SceneSaveload capture");
+		capture_job.clear();
+	}
+	for (const PendingCapture &pending : pending_captures) {
+		SyncherGroup &group = r_saveload_state.syncher_groups[pending.group];
+		for (uint32_t i = 0; i < pending.sync->pending_properties.size(); i++) {
+			// Properties left out of this save's tier are not in the group, and stay pending.
+			const uint32_t property_id = path_table.find(pending.sync->pending_properties[i]);
+			for (uint32_t j = 0; j < group.properties.size(); j++) {
+				if (group.properties[j] == property_id) {
+					group.columns[j][pending.instance] = pending.sync->pending_values[i];
+					group.missing[j][pending.instance] = 0;
+					break;
+				}
+			}
+		}
+	}
+	// Groups end up in the order their configs were first met, as in a fresh capture, and groups
+	// whose config no synchronizer uses any more are dropped. Only a change of configs moves any.
+	bool in_order = capture_group_order.size() == r_saveload_state.syncher_groups.size();
+	for (uint32_t i = 0; i < capture_group_order.size() && in_order; i++) {
+		in_order = capture_group_order[i] == i;
+	}
+	if (!in_order) {
+		LocalVector<SyncherGroup> groups;
+		groups.reserve(capture_group_order.size());
+		for (const uint32_t i : capture_group_order) {
+			groups.push_back(r_saveload_state.syncher_groups[i]);
+		}
+		r_saveload_state.syncher_groups = groups;
+		r_saveload_state.config_groups.clear();
+		for (uint32_t i = 0; i < groups.size(); i++) {
+			r_saveload_state.config_groups.insert(groups[i].config->get_instance_id(), i);
+		}
+	}
+}
+
+void SceneSaveload::ApplyJob::clear() {
+	group = nullptr;
+	property_begin = 0;
+	targets.clear();
+	batches.clear();
+}
+
+void SceneSaveload::_find_apply_properties(const SyncherGroup &p_group, Node *p_root_node) {
+	// As when capturing, GDExtension builds look each property up once per group, on its first
+	// synchronizer, as their set_indexed() silently ignores properties the object does not have.
+	apply_property_exists.resize(p_group.properties.size());
+	for (uint32_t i = 0; i < p_group.properties.size(); i++) {
+		const NodePath &property = path_table.get_path(p_group.properties[i]);
+		// Objects that cannot be found are reported when their synchronizers are set.
+		const Object *object = property.get_name_count() == 0 || p_root_node->has_node(property) ? SaveloadSynchronizer::get_property_object(p_root_node, property) : nullptr;
+		apply_property_exists[i] = !object || SaveloadSynchronizer::has_indexed(object, property);
+	}
+}
+
+void SceneSaveload::_apply_batch(uint32_t p_batch) {
+	const TaskBatch &batch = apply_job.batches[p_batch];
+	const SyncherGroup &group = *apply_job.group;
+	// Property by property, so each node gets this run's properties in order.
+	for (uint32_t i = 0; i < apply_job.targets.size(); i++) {
+		const uint32_t property_index = apply_job.property_begin + i;
+		const NodePath &property = path_table.get_path(group.properties[property_index]);
+		const LocalVector<Object *> &targets = apply_job.targets[i];
+		const LocalVector<Variant> &column = group.columns[property_index];
+		for (uint32_t instance = batch.begin; instance < batch.end; instance++) {
+			if (targets[instance] && !group.is_missing(property_index, instance)) {
+				SaveloadSynchronizer::write_indexed(targets[instance], property, apply_property_exists[property_index], column[instance]);
+			}
+		}
+	}
+}
+
+void SceneSaveload::_apply_threaded(const SaveloadState &p_saveload_state) {
+	LocalVector<Node *> root_nodes;
+	LocalVector<bool> task_instances; // Whether the tasks may set each synchronizer's thread-safe properties.
+	LocalVector<bool> property_thread_safe;
+	for (const SyncherGroup &group : p_saveload_state.syncher_groups) {
+		const uint32_t instance_count = group.synchers.size();
+		root_nodes.resize(instance_count);
+		task_instances.resize(instance_count);
+		Ref<SceneSaveloadConfig> config;
+		for (uint32_t instance = 0; instance < instance_count; instance++) {
+			root_nodes[instance] = nullptr;
+			task_instances[instance] = false;
+			const NodePath &sync_path = path_table.get_path(group.synchers[instance]);
+			SaveloadSynchronizer *sync_node = get_node<SaveloadSynchronizer>(sync_path);
+			ERR_CONTINUE_MSG(!sync_node, vformat("could not find SaveloadSynchronizer at path %s", sync_path));
+			root_nodes[instance] = sync_node->get_root_node();
+			ERR_CONTINUE_MSG(!root_nodes[instance], vformat("Could not find root node at %s.", sync_node->get_root_path()));
+			if (config.is_null()) {
+				config = sync_node->get_saveload_config();
+			}
+			// Loaded groups carry no config, so the thread-safe flags come from the synchronizers' own.
+			// Synchronizers that use another config than the first one are set on the main thread.
+			task_instances[instance] = sync_node->get_saveload_config() == config;
+		}
+		uint32_t first_instance = 0;
+		while (first_instance < instance_count && !root_nodes[first_instance]) {
+			first_instance++;
+		}
+		if (first_instance == instance_count) {
+			continue;
+		}
+		_find_apply_properties(group, root_nodes[first_instance]);
+
+		property_thread_safe.resize(group.properties.size());
+		for (uint32_t i = 0; i < group.properties.size(); i++) {
+			const NodePath &property = path_table.get_path(group.properties[i]);
+			property_thread_safe[i] = config.is_valid() && config->has_property(property) && config->property_get_thread_safe(property);
+		}
+
+		uint32_t begin = 0;
+		while (begin < group.properties.size()) {
+			const bool thread_safe = property_thread_safe[begin];
+			uint32_t end = begin + 1;
+			while (end < group.properties.size() && property_thread_safe[end] == thread_safe) {
+				end++;
+			}
+			if (thread_safe) {
+				// Objects are resolved once the earlier runs are set, as their setters may change the tree.
+				apply_job.clear();
+				apply_job.group = &group;
+				apply_job.property_begin = begin;
+				apply_job.targets.resize(end - begin);
+				for (uint32_t i = begin; i < end; i++) {
+					LocalVector<Object *> &targets = apply_job.targets[i - begin];
+					targets.resize(instance_count);
+					for (uint32_t instance = 0; instance < instance_count; instance++) {
+						targets[instance] = root_nodes[instance] && task_instances[instance] ? SaveloadSynchronizer::get_property_node(root_nodes[instance], path_table.get_path(group.properties[i])) : nullptr;
+					}
+				}
+				for (uint32_t batch_begin = 0; batch_begin < instance_count; batch_begin += TASK_BATCH_SIZE) {
+					TaskBatch batch;
+					batch.begin = batch_begin;
+					batch.end = MIN(batch_begin + TASK_BATCH_SIZE, instance_count);
+					apply_job.batches.push_back(batch);
+				}
+				_run_group_task(&SceneSaveload::_apply_batch, apply_job.batches.size(), "SceneSaveload apply");
+				apply_job.clear();
+			}
+			for (uint32_t instance = 0; instance < instance_count; instance++) {
+				if (!root_nodes[instance] || (thread_safe && task_instances[instance])) {
+					continue;
+				}
+				for (uint32_t i = begin; i < end; i++) {
+					if (group.is_missing(i, instance)) {
+						continue;
+					}
+					const NodePath &property = path_table.get_path(group.properties[i]);
+					Object *object = SaveloadSynchronizer::get_property_node(root_nodes[instance], property);
+					if (object) {
+						SaveloadSynchronizer::write_indexed(object, property, apply_property_exists[i], group.columns[i][instance]);
+					}
+				}
+			}
+			begin = end;
+		}
+	}
+}
+
+Error SceneSaveload::load_saveload_state(SaveloadState &r_saveload_state, bool p_threaded, bool p_lazy) {
+	_count_state(r_saveload_state);
+	// An earlier lazy load's values are superseded by this one.
+	for (SaveloadSynchronizer *sync : synchers) {
+		sync->clear_pending_state();
+	}
+	{
+		PhaseTimer timer(this, PHASE_SPAWN);
+		for (const KeyValue<uint32_t, SaveloadSpawner::SpawnerState> &spawner_state : r_saveload_state.spawner_states) {
+			const NodePath &spawner_path = path_table.get_path(spawner_state.key);
+			SaveloadSpawner *spawner_node = get_node<SaveloadSpawner>(spawner_path);
+			ERR_CONTINUE_MSG(!spawner_node, vformat("could not find SaveloadSpawner at path %s", spawner_path));
+			spawner_node->load_spawn_state(spawner_state.value);
+		}
+	}
+	PhaseTimer timer(this, PHASE_APPLY);
+	// Spawned synchronizers only exist from here on, and their configs tell which groups need migrating.
+	_migrate(r_saveload_state);
+	if (p_lazy) {
+		_defer_disabled(r_saveload_state);
+	}
+	if (p_threaded) {
+		_apply_threaded(r_saveload_state);
+		return OK;
 	}
-	for (const KeyValue<const NodePath, SaveloadSynchronizer::SyncherState> &sync_state : p_saveload_state.syncher_states) {
-		SaveloadSynchronizer *sync_node = get_node<SaveloadSynchronizer>(sync_state.key);
-		ERR_CONTINUE_MSG(!sync_node, vformat("could not find SaveloadSynchronizer at path %s", sync_state.key));
-		sync_node->set_syncher_state(sync_state.value);
+	for (const SyncherGroup &group : r_saveload_state.syncher_groups) {
+		bool found_properties = false;
+		for (uint32_t instance = 0; instance < group.synchers.size(); instance++) {
+			const NodePath &sync_path = path_table.get_path(group.synchers[instance]);
+			SaveloadSynchronizer *sync_node = get_node<SaveloadSynchronizer>(sync_path);
+			ERR_CONTINUE_MSG(!sync_node, vformat("could not find SaveloadSynchronizer at path %s", sync_path));
+			Node *root_node = sync_node->get_root_node();
+			ERR_CONTINUE_MSG(!root_node, vformat("Could not find root node at %s.", sync_node->get_root_path()));
+			if (!found_properties) {
+				_find_apply_properties(group, root_node);
+				found_properties = true;
+			}
+			for (uint32_t i = 0; i < group.properties.size(); i++) {
+				// Properties that could not be read when saving keep whatever the node holds.
+				if (group.is_missing(i, instance)) {
+					continue;
+				}
+				const NodePath &property = path_table.get_path(group.properties[i]);
+				Object *object = SaveloadSynchronizer::get_property_node(root_node, property);
+				if (object) {
+					SaveloadSynchronizer::write_indexed(object, property, apply_property_exists[i], group.columns[i][instance]);
+				}
+			}
+		}
 	}
 	return OK; //TODO: return some errors
 }
 
+void SceneSaveload::_defer_disabled(SaveloadState &r_saveload_state) {
+	for (SyncherGroup &group : r_saveload_state.syncher_groups) {
+		uint32_t kept = 0;
+		for (uint32_t instance = 0; instance < group.synchers.size(); instance++) {
+			SaveloadSynchronizer *sync_node = get_node<SaveloadSynchronizer>(path_table.get_path(group.synchers[instance]));
+			if (sync_node && sync_node->is_disabled()) {
+				for (uint32_t i = 0; i < group.properties.size(); i++) {
+					if (!group.is_missing(i, instance)) {
+						sync_node->add_pending_property(path_table.get_path(group.properties[i]), group.columns[i][instance]);
+					}
+				}
+				continue;
+			}
+			// Synchronizers that are applied now are compacted to the front, keeping their order.
+			if (kept != instance) {
+				group.synchers[kept] = group.synchers[instance];
+				for (LocalVector<Variant> &column : group.columns) {
+					column[kept] = column[instance];
+				}
+				for (LocalVector<uint8_t> &flags : group.missing) {
+					if (instance < flags.size()) {
+						flags[kept] = flags[instance];
+					}
+				}
+			}
+			kept++;
+		}
+		group.synchers.resize(kept);
+		for (LocalVector<Variant> &column : group.columns) {
+			column.resize(kept);
+		}
+		for (LocalVector<uint8_t> &flags : group.missing) {
+			flags.resize(MIN(flags.size(), kept));
+		}
+	}
+}
+
+void SceneSaveload::_migrate(SaveloadState &r_saveload_state) {
+	if (migrations.is_empty()) {
+		return;
+	}
+	for (SyncherGroup &group : r_saveload_state.syncher_groups) {
+		// Every synchronizer of a group shared one config when saved, so the first one found stands for all.
+		Ref<SceneSaveloadConfig> config;
+		for (uint32_t instance = 0; instance < group.synchers.size() && config.is_null(); instance++) {
+			SaveloadSynchronizer *sync_node = get_node<SaveloadSynchronizer>(path_table.get_path(group.synchers[instance]));
+			if (sync_node) {
+				config = sync_node->get_saveload_config();
+			}
+		}
+		if (config.is_null() || config->get_schema_fingerprint() == group.fingerprint) {
+			continue;
+		}
+		Array properties;
+		for (const uint32_t property : group.properties) {
+			properties.push_back(path_table.get_path(property));
+		}
+		Array synchers;
+		for (const uint32_t syncher : group.synchers) {
+			synchers.push_back(path_table.get_path(syncher));
+		}
+		Array columns;
+		for (const LocalVector<Variant> &column : group.columns) {
+			Array values;
+			values.resize(column.size());
+			for (uint32_t i = 0; i < column.size(); i++) {
+				values[i] = column[i];
+			}
+			columns.push_back(values);
+		}
+		// Values that could not be read when saving are passed as null, and stay unset unless a migration fills them in.
+		HashMap<uint32_t, LocalVector<uint8_t>> missing_by_property;
+		for (uint32_t i = 0; i < group.missing.size() && i < group.properties.size(); i++) {
+			missing_by_property.insert(group.properties[i], group.missing[i]);
+		}
+		Dictionary group_dict;
+		group_dict[StringName("fingerprint")] = (int64_t)group.fingerprint;
+		group_dict[StringName("properties")] = properties;
+		group_dict[StringName("synchronizers")] = synchers;
+		group_dict[StringName("values")] = columns;
+		Array args;
+		args.push_back(group_dict);
+		args.push_back(config);
+		for (const Callable &migration : migrations) {
+			migration.callv(args);
+		}
+		// Migrations edit the dictionary in place and may rename, add or drop properties, but not synchronizers.
+		properties = group_dict[StringName("properties")];
+		columns = group_dict[StringName("values")];
+		ERR_CONTINUE_MSG(properties.size() != columns.size(), "Migrated synchronizer group must have one values array per property.");
+		bool valid = true;
+		for (int i = 0; i < columns.size() && valid; i++) {
+			valid = columns[i].get_type() == Variant::ARRAY && ((Array)columns[i]).size() == (int)group.synchers.size();
+		}
+		ERR_CONTINUE_MSG(!valid, "Migrated synchronizer group must have one value per synchronizer for each property.");
+		const LocalVector<uint32_t> old_properties = group.properties;
+		group.properties.resize(properties.size());
+		group.columns.resize(columns.size());
+		for (int i = 0; i < properties.size(); i++) {
+			group.properties[i] = path_table.intern(properties[i]);
+			const Array values = columns[i];
+			group.columns[i].resize(values.size());
+			for (int j = 0; j < values.size(); j++) {
+				group.columns[i][j] = values[j];
+			}
+		}
+		group.missing.clear();
+		if (!missing_by_property.is_empty()) {
+			group.resize_missing();
+			for (uint32_t i = 0; i < group.properties.size(); i++) {
+				// A property renamed in place takes the flags of the one it replaced. Values the migrations
+				// filled in are set like any other.
+				HashMap<uint32_t, LocalVector<uint8_t>>::ConstIterator flags = missing_by_property.find(group.properties[i]);
+				if (!flags && i < old_properties.size()) {
+					flags = missing_by_property.find(old_properties[i]);
+				}
+				if (!flags || flags->value.size() != group.synchers.size()) {
+					continue;
+				}
+				for (uint32_t j = 0; j < group.synchers.size(); j++) {
+					group.missing[i][j] = flags->value[j] && group.columns[i][j].get_type() == Variant::NIL;
+				}
+			}
+		}
+		group.fingerprint = config->get_schema_fingerprint();
+	}
+}
+
+SceneSaveload::SyncherGroup::SyncherGroup(const LocalVector<uint32_t> &p_properties) {
+	properties = p_properties;
+	columns.resize(properties.size());
+}
+
+void SceneSaveload::SyncherGroup::resize_missing() {
+	missing.resize(properties.size());
+	for (LocalVector<uint8_t> &flags : missing) {
+		flags.resize(synchers.size());
+		if (flags.size()) {
+			memset(flags.ptr(), 0, flags.size());
+		}
+	}
+}
+
+uint32_t SceneSaveload::SyncherGroup::add_syncher(uint32_t p_path_id) {
+	synchers.push_back(p_path_id);
+	for (LocalVector<Variant> &column : columns) {
+		column.resize(synchers.size());
+	}
+	for (LocalVector<uint8_t> &flags : missing) {
+		flags.push_back(0);
+	}
+	return synchers.size() - 1;
+}
+
+void SceneSaveload::SaveloadState::release_values() {
+	spawner_states.clear();
+	for (SyncherGroup &group : syncher_groups) {
+		for (LocalVector<Variant> &column : group.columns) {
+			column.clear();
+		}
+		for (LocalVector<uint8_t> &flags : group.missing) {
+			flags.clear();
+		}
+	}
+}
+
 Dictionary SceneSaveload::SaveloadState::to_dict() const {
+	const SaveloadPathTable *paths = SaveloadPathTable::get_singleton();
 	Dictionary dict;
 	Dictionary spawn_dict;
-	for (const KeyValue<const NodePath, SaveloadSpawner::SpawnerState> &spawn_state : SaveloadState::spawner_states) {
-		spawn_dict[spawn_state.key] = spawn_state.value.to_array();
+	for (const KeyValue<uint32_t, SaveloadSpawner::SpawnerState> &spawn_state : SaveloadState::spawner_states) {
+		spawn_dict[paths->get_path(spawn_state.key)] = spawn_state.value.to_array();
 	}
 	Dictionary sync_dict;
-	for (const KeyValue<const NodePath, SaveloadSynchronizer::SyncherState> &sync_state : SaveloadState::syncher_states) {
-		sync_dict[sync_state.key] = sync_state.value.to_dict();
+	Dictionary schema_dict;
+	for (const SyncherGroup &group : syncher_groups) {
+		for (uint32_t instance = 0; instance < group.synchers.size(); instance++) {
+			Dictionary property_dict;
+			for (uint32_t i = 0; i < group.properties.size(); i++) {
+				if (!group.is_missing(i, instance)) {
+					property_dict[paths->get_path(group.properties[i])] = group.columns[i][instance];
+				}
+			}
+			const NodePath &sync_path = paths->get_path(group.synchers[instance]);
+			sync_dict[sync_path] = property_dict;
+			schema_dict[sync_path] = (int64_t)group.fingerprint;
+		}
 	}
+	dict[StringName("version")] = STATE_VERSION;
 	dict[StringName("spawn_states")] = spawn_dict;
 	dict[StringName("sync_states")] = sync_dict;
+	dict[StringName("schemas")] = schema_dict;
 	return dict;
 }
 
 SceneSaveload::SaveloadState::SaveloadState(const Dictionary &p_saveload_dict) {
 	Dictionary spawn_states_dict = p_saveload_dict[StringName("spawn_states")];
 	Dictionary sync_states_dict = p_saveload_dict[StringName("sync_states")];
+	// Missing before version 1, which leaves every fingerprint unknown.
+	Dictionary schemas_dict = p_saveload_dict.get(StringName("schemas"), Dictionary());
+	SaveloadPathTable *paths = SaveloadPathTable::get_singleton();
+	// Synchronizers saved with the same schema and property list end up in the same group.
+	HashMap<String, uint32_t> group_indices;
 #ifdef GDEXTENSION
     Array spawn_keys = spawn_states_dict.keys();
     for (int i = 0; i < spawn_keys.size(); i++) {
         NodePath spawn_key = spawn_keys[i];
         TypedArray<Dictionary> spawn_state_as_array = spawn_states_dict[spawn_key];
-        spawner_states.insert(spawn_key, SaveloadSpawner::SpawnerState(spawn_state_as_array));
+        spawner_states.insert(paths->intern(spawn_key), SaveloadSpawner::SpawnerState())->value.set_spawn_infos(spawn_state_as_array);
     }
     Array sync_keys = sync_states_dict.keys();
     for (int i = 0; i < sync_keys.size(); i++) {
         NodePath sync_key = sync_keys[i];
         Dictionary sync_state_as_dict = sync_states_dict[sync_key];
-        syncher_states.insert(sync_key, SaveloadSynchronizer::SyncherState(sync_state_as_dict));
+        Array property_keys = sync_state_as_dict.keys();
+        const uint64_t fingerprint = (int64_t)schemas_dict.get(sync_key, 0);
+        const String signature = itos(fingerprint) + ":" + String(",").join(property_keys);
+        HashMap<String, uint32_t>::Iterator group_index = group_indices.find(signature);
+        if (!group_index) {
+            LocalVector<uint32_t> properties;
+            for (int j = 0; j < property_keys.size(); j++) {
+                properties.push_back(paths->intern(property_keys[j]));
+            }
+            syncher_groups.push_back(SyncherGroup(properties));
+            syncher_groups[syncher_groups.size() - 1].fingerprint = fingerprint;
+            group_index = group_indices.insert(signature, syncher_groups.size() - 1);
+        }
+        SyncherGroup &group = syncher_groups[group_index->value];
+        const uint32_t instance = group.add_syncher(paths->intern(sync_key));
+        for (int j = 0; j < property_keys.size(); j++) {
+            group.columns[j][instance] = sync_state_as_dict[property_keys[j]];
+        }
     }
 #elif
     List<Variant> spawn_keys;
 	spawn_states_dict.get_key_list(&spawn_keys);
 	for (const NodePath spawn_key : spawn_keys) {
 		TypedArray<Dictionary> spawn_state_as_array = spawn_states_dict[spawn_key];
-		spawner_states.insert(spawn_key, SaveloadSpawner::SpawnerState(spawn_state_as_array));
+		spawner_states.insert(paths->intern(spawn_key), SaveloadSpawner::SpawnerState())->value.set_spawn_infos(spawn_state_as_array);
 	}
 	List<Variant> sync_keys;
 	sync_states_dict.get_key_list(&sync_keys);
 	for (const NodePath sync_key : sync_keys) {
 		Dictionary sync_state_as_dict = sync_states_dict[sync_key];
-		syncher_states.insert(sync_key, SaveloadSynchronizer::SyncherState(sync_state_as_dict));
+		Array property_keys = sync_state_as_dict.keys();
+		const uint64_t fingerprint = (int64_t)schemas_dict.get(sync_key, 0);
+		const String signature = itos(fingerprint) + ":" + String(",").join(property_keys);
+		HashMap<String, uint32_t>::Iterator group_index = group_indices.find(signature);
+		if (!group_index) {
+			LocalVector<uint32_t> properties;
+			for (int j = 0; j < property_keys.size(); j++) {
+				properties.push_back(paths->intern(property_keys[j]));
+			}
+			syncher_groups.push_back(SyncherGroup(properties));
+			syncher_groups[syncher_groups.size() - 1].fingerprint = fingerprint;
+			group_index = group_indices.insert(signature, syncher_groups.size() - 1);
+		}
+		SyncherGroup &group = syncher_groups[group_index->value];
+		const uint32_t instance = group.add_syncher(paths->intern(sync_key));
+		for (int j = 0; j < property_keys.size(); j++) {
+			group.columns[j][instance] = sync_state_as_dict[property_keys[j]];
+		}
 	}
 #endif
 }
 
 Variant SceneSaveload::serialize(const Variant &p_configuration_data) {
-	return get_saveload_state().to_dict();
+	PathHold path_hold(this);
+	const uint64_t start = get_ticks_usec();
+	_begin_operation("serialize");
+	const int tier = _get_option(p_configuration_data, "tier", (int)SceneSaveloadConfig::TIER_COLD);
+	ERR_FAIL_INDEX_V_MSG(tier, SceneSaveloadConfig::TIER_MAX, Variant(), vformat("Invalid save tier %d.", tier));
+	SaveloadState saveload_state;
+	{
+		PhaseTimer timer(this, PHASE_SNAPSHOT);
+		if (_get_option(p_configuration_data, "canonical", false)) {
+			_sort_tracked();
+		}
+		saveload_state = get_saveload_state(_get_option(p_configuration_data, "threaded_capture", false), (SceneSaveloadConfig::SaveTier)tier);
+	}
+	_count_state(saveload_state);
+	Dictionary dict;
+	{
+		PhaseTimer timer(this, PHASE_ENCODE);
+		dict = saveload_state.to_dict();
+	}
+	_end_operation(start);
+	return dict;
 }
 
 Error SceneSaveload::deserialize(const Variant &p_serialized_state, const Variant &p_configuration_data) {
-	return load_saveload_state(SaveloadState(p_serialized_state));
+	PathHold path_hold(this);
+	const uint64_t start = get_ticks_usec();
+	_begin_operation("deserialize");
+	ERR_FAIL_COND_V_MSG(p_serialized_state.get_type() != Variant::DICTIONARY, ERR_INVALID_PARAMETER, "Serialized saveload state must be a Dictionary.");
+	const int version = ((Dictionary)p_serialized_state).get(StringName("version"), 0);
+	ERR_FAIL_COND_V_MSG(version > STATE_VERSION, ERR_FILE_UNRECOGNIZED, vformat("Serialized saveload state version %d is newer than the supported version %d.", version, STATE_VERSION));
+	SaveloadState saveload_state;
+	{
+		PhaseTimer timer(this, PHASE_DECODE);
+		saveload_state = SaveloadState(p_serialized_state);
+	}
+	Error err = load_saveload_state(saveload_state, _get_option(p_configuration_data, "threaded_apply", false), _get_option(p_configuration_data, "lazy_apply", false));
+	_end_operation(start);
+	return err;
+}
+
+Error SceneSaveload::_encode_save(PackedByteArray &r_bytes, const Variant &p_configuration_data) {
+	const int tier = _get_option(p_configuration_data, "tier", (int)SceneSaveloadConfig::TIER_COLD);
+	ERR_FAIL_INDEX_V_MSG(tier, SceneSaveloadConfig::TIER_MAX, ERR_INVALID_PARAMETER, vformat("Invalid save tier %d.", tier));
+	{
+		PhaseTimer timer(this, PHASE_SNAPSHOT);
+		if (_get_option(p_configuration_data, "canonical", false)) {
+			_sort_tracked();
+		}
+		get_saveload_state(save_state, _get_option(p_configuration_data, "threaded_capture", false), (SceneSaveloadConfig::SaveTier)tier);
+	}
+	_count_state(save_state);
+	PhaseTimer timer(this, PHASE_ENCODE);
+	if (!save_encoder) {
+		save_encoder = memnew(SaveloadEncoder);
+	}
+	save_encoder->set_allow_objects(_get_option(p_configuration_data, "allow_objects", false));
+	Error err = save_encoder->encode(save_state, r_bytes);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Unable to encode saveload state.");
+	if (instrumentation_enabled) {
+		last_operation_stats.scratch_allocations += save_encoder->get_allocation_count();
+	}
+	// Values are not kept alive until the next save.
+	save_state.release_values();
+	return OK;
+}
+
+bool SceneSaveload::_is_saved(const String &p_path, const PackedByteArray &p_bytes, int p_compression) {
+	if (!FileAccess::file_exists(p_path)) {
+		return false;
+	}
+	// Canonical saves of an unchanged scene hash the same, so the header of the existing file tells
+	// whether it holds the same content. Its body is then checked against those hashes as well, so a
+	// truncated or damaged file is written again rather than kept.
+	PhaseTimer timer(this, PHASE_READ);
+	Ref<FileAccess> existing = FileAccess::open(p_path, FileAccess::READ);
+	if (existing.is_null() || !SaveloadEncoder::has_same_content(p_bytes, existing->get_buffer(SaveloadEncoder::HEADER_SIZE), p_compression)) {
+		return false;
+	}
+	existing.unref();
+	return SaveloadDecoder::validate(p_path) == OK;
+}
+
+Error SceneSaveload::_get_write_options(const Variant &p_configuration_data, WriteOptions &r_options) {
+	r_options.compression = _get_option(p_configuration_data, "compression", FileAccess::COMPRESSION_ZSTD);
+	r_options.store_directory = _get_option(p_configuration_data, "store_directory", String());
+	r_options.uncached = _get_option(p_configuration_data, "uncached_write", false);
+	// Any other type would convert to an empty key and quietly save in the clear.
+	const Variant key = _get_option(p_configuration_data, "encryption_key", PackedByteArray());
+	ERR_FAIL_COND_V_MSG(key.get_type() != Variant::PACKED_BYTE_ARRAY, ERR_INVALID_PARAMETER, "encryption_key must be a PackedByteArray.");
+	r_options.encryption_key = key;
+	return OK;
+}
+
+void SceneSaveload::_cipher_block(uint32_t p_block) {
+	cipher_job->process_block(p_block);
+}
+
+void SceneSaveload::_run_cipher(SaveloadCipher &p_cipher, bool p_threaded) {
+	if (!p_threaded) {
+		p_cipher.process_all();
+		return;
+	}
+	cipher_job = &p_cipher;
+	_run_group_task(&SceneSaveload::_cipher_block, p_cipher.get_block_count(), "Saveload encryption");
+	cipher_job = nullptr;
+}
+
+Error SceneSaveload::_write_save(const String &p_path, PackedByteArray &r_bytes, const WriteOptions &p_options, bool p_main_thread, uint64_t &r_chunk_bytes) {
+	SceneSaveload *timed = p_main_thread ? this : nullptr;
+	const bool encrypted = !p_options.encryption_key.is_empty();
+	// Chunks are shared between saves and stored as they are, so they cannot be encrypted.
+	ERR_FAIL_COND_V_MSG(encrypted && !p_options.store_directory.is_empty(), ERR_INVALID_PARAMETER, "Encrypted saves cannot use a store_directory.");
+	if (!p_options.store_directory.is_empty()) {
+		// The store compresses each chunk on its own and the file becomes its manifest.
+		PhaseTimer timer(timed, PHASE_WRITE);
+		PackedByteArray manifest;
+		Error err = SaveloadChunkStore::store(r_bytes, p_options.store_directory, p_options.compression, manifest, r_chunk_bytes);
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Unable to store saveload state in %s.", p_options.store_directory));
+		r_bytes = manifest;
+	} else {
+		PhaseTimer timer(timed, PHASE_COMPRESS);
+		Error err = SaveloadEncoder::compress(r_bytes, p_options.compression);
+		ERR_FAIL_COND_V_MSG(err != OK, err, "Unable to compress saveload state.");
+	}
+	if (encrypted) {
+		PhaseTimer timer(timed, PHASE_ENCRYPT);
+		SaveloadCipher cipher;
+		Error err = cipher.begin_encrypt(r_bytes, p_options.encryption_key);
+		if (err != OK) {
+			return err;
+		}
+		_run_cipher(cipher, p_main_thread);
+		err = cipher.finish(r_bytes);
+		if (err != OK) {
+			return err;
+		}
+	}
+	PhaseTimer timer(timed, PHASE_WRITE);
+	return SaveloadFileWriter::write(p_path, r_bytes, p_options.uncached);
 }
 
 Error SceneSaveload::save(const String &p_path, const Variant &p_configuration_data) {
-    Error err;
+	PathHold path_hold(this);
+	const uint64_t start = get_ticks_usec();
+	_begin_operation("save");
+	WriteOptions options;
+	Error err = _get_write_options(p_configuration_data, options);
+	if (err != OK) {
+		return err;
+	}
+	// Declared before the saved bytes so they are freed by the time it measures.
+	MemoryProbe memory_probe(this);
+	PackedByteArray bytes;
+	err = _encode_save(bytes, p_configuration_data);
+	if (err != OK) {
+		return err;
+	}
+	// This save supersedes queued ones to the same path, and must not be overwritten by one in flight.
+	if (_drop_queued_saves(p_path)) {
+		_emit_save_queue_changed();
+	}
+	if (save_task_id >= 0 && active_save.path == p_path) {
+		_finish_active_save();
+	}
+	if (_get_option(p_configuration_data, "canonical", false) && _is_saved(p_path, bytes, options.compression)) {
+		if (instrumentation_enabled) {
+			last_operation_stats.byte_count = 0;
+		}
+		_end_operation(start);
+		return OK;
+	}
+	uint64_t chunk_bytes = 0;
+	err = _write_save(p_path, bytes, options, true, chunk_bytes);
+	if (err != OK) {
+		return err;
+	}
+	if (instrumentation_enabled) {
+		last_operation_stats.byte_count = bytes.size() + chunk_bytes;
+	}
+	_end_operation(start);
+	return OK;
+}
+
+Error SceneSaveload::save_async(const String &p_path, const Variant &p_configuration_data) {
+	PathHold path_hold(this);
+	const uint64_t start = get_ticks_usec();
+	_begin_operation("save_async");
+	QueuedSave queued;
+	queued.path = p_path;
+	Error err = _get_write_options(p_configuration_data, queued.options);
+	if (err != OK) {
+		return err;
+	}
+	// Capturing must happen on the main thread; only compressing and writing are left to the task.
+	err = _encode_save(queued.bytes, p_configuration_data);
+	if (err != OK) {
+		return err;
+	}
+	queued.size = queued.bytes.size();
+	// Writes that already ended free their memory before the new save is weighed against the limit.
+	_poll_save_queue();
+	if (_get_option(p_configuration_data, "canonical", false) && !_is_save_pending(p_path) && _is_saved(p_path, queued.bytes, queued.options.compression)) {
+		_end_operation(start);
+		return OK;
+	}
+	bool changed = false;
+	if (save_queue_policy == SAVE_QUEUE_COALESCE) {
+		// Only the latest state of a path is worth writing, whatever the budget.
+		changed = _drop_queued_saves(p_path) > 0;
+	}
+	// A save larger than the limit is still taken when nothing else is queued, or it could never be written.
+	const bool idle = save_task_id < 0 && save_queue.is_empty();
+	if (!idle && queued_save_bytes + queued.size > save_queue_memory_limit) {
+		if (save_queue_policy == SAVE_QUEUE_BLOCK) {
+			while (save_task_id >= 0 && queued_save_bytes + queued.size > save_queue_memory_limit) {
+				_finish_active_save();
+			}
+		} else {
+			if (changed) {
+				_emit_save_queue_changed();
+			}
+			_end_operation(start);
+			ERR_FAIL_V_MSG(ERR_BUSY, vformat("Save queue is over its memory limit of %d bytes, dropping the save to %s.", (int64_t)save_queue_memory_limit, p_path));
+		}
+	}
+	queued_save_bytes += queued.size;
+	save_queue.push_back(queued);
+	_start_next_save();
+	_emit_save_queue_changed();
+	if (instrumentation_enabled) {
+		last_operation_stats.byte_count = queued.size;
+	}
+	_end_operation(start);
+	return OK;
+}
+
+void SceneSaveload::_write_active_save() {
+	uint64_t chunk_bytes = 0;
+	active_save.error = _write_save(active_save.path, active_save.bytes, active_save.options, false, chunk_bytes);
+}
+
+void SceneSaveload::_start_next_save() {
+	if (save_task_id >= 0 || save_queue.is_empty()) {
+		_set_save_queue_processing(save_task_id >= 0);
+		return;
+	}
+	active_save = save_queue[0];
+	save_queue.remove_at(0);
+	save_task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &SceneSaveload::_write_active_save), false, "Saveload async save");
+	_set_save_queue_processing(true);
+}
+
+void SceneSaveload::_finish_active_save() {
+	ERR_FAIL_COND(save_task_id < 0);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(save_task_id);
+	save_task_id = -1;
+	queued_save_bytes -= active_save.size;
+	const String path = active_save.path;
+	const Error err = active_save.error;
+	active_save = QueuedSave();
+	_start_next_save();
+	emit_signal(StringName("save_completed"), path, err);
+	_emit_save_queue_changed();
+}
+
+void SceneSaveload::_poll_save_queue() {
+	if (save_task_id >= 0 && WorkerThreadPool::get_singleton()->is_task_completed(save_task_id)) {
+		_finish_active_save();
+	}
+}
+
+bool SceneSaveload::_is_save_pending(const String &p_path) const {
+	if (save_task_id >= 0 && active_save.path == p_path) {
+		return true;
+	}
+	for (const QueuedSave &queued : save_queue) {
+		if (queued.path == p_path) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t SceneSaveload::_drop_queued_saves(const String &p_path) {
+	uint32_t dropped = 0;
+	for (uint32_t i = 0; i < save_queue.size();) {
+		if (save_queue[i].path == p_path) {
+			queued_save_bytes -= save_queue[i].size;
+			save_queue.remove_at(i);
+			dropped++;
+		} else {
+			i++;
+		}
+	}
+	return dropped;
+}
+
+void SceneSaveload::_set_save_queue_processing(bool p_processing) {
+	// Finished writes are collected once per frame while any are in flight.
 #ifdef GDEXTENSION
-    Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
-    err = file->get_error();
+	SceneTree *tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
 #elif
-	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	SceneTree *tree = SceneTree::get_singleton();
 #endif
-    if (err != OK) {
-        return err;
-    }
-    file->store_var(serialize(), false);
-    file->close();
-    return err;
+	if (!tree) {
+		return;
+	}
+	const Callable poll = callable_mp(this, &SceneSaveload::_poll_save_queue);
+	if (p_processing && !tree->is_connected(StringName("process_frame"), poll)) {
+		tree->connect(StringName("process_frame"), poll);
+	} else if (!p_processing && tree->is_connected(StringName("process_frame"), poll)) {
+		tree->disconnect(StringName("process_frame"), poll);
+	}
+}
+
+void SceneSaveload::_emit_save_queue_changed() {
+	emit_signal(StringName("save_queue_changed"), get_save_queue_depth(), get_save_queue_bytes());
+}
+
+void SceneSaveload::flush_saves() {
+	while (save_task_id >= 0) {
+		_finish_active_save();
+	}
+}
+
+void SceneSaveload::set_save_queue_memory_limit(int64_t p_bytes) {
+	ERR_FAIL_COND(p_bytes < 0);
+	save_queue_memory_limit = p_bytes;
+}
+
+int64_t SceneSaveload::get_save_queue_memory_limit() const {
+	return save_queue_memory_limit;
+}
+
+void SceneSaveload::set_save_queue_policy(SaveQueuePolicy p_policy) {
+	ERR_FAIL_INDEX(p_policy, SAVE_QUEUE_POLICY_MAX);
+	save_queue_policy = p_policy;
+}
+
+SceneSaveload::SaveQueuePolicy SceneSaveload::get_save_queue_policy() const {
+	return save_queue_policy;
+}
+
+int SceneSaveload::get_save_queue_depth() const {
+	return save_queue.size() + (save_task_id >= 0 ? 1 : 0);
+}
+
+int64_t SceneSaveload::get_save_queue_bytes() const {
+	return queued_save_bytes;
 }
 
 Error SceneSaveload::load(const String &p_path, const Variant &p_configuration_data) {
+	PathHold path_hold(this);
+	const uint64_t start = get_ticks_usec();
+	_begin_operation("load");
+	if (_is_save_pending(p_path)) {
+		// The file on disk is older than a save already requested.
+		flush_saves();
+	}
 	Error err;
+	PackedByteArray bytes;
+	{
+		PhaseTimer timer(this, PHASE_READ);
 #ifdef GDEXTENSION
-    Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
-    err = file->get_error();
+		Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
+		err = FileAccess::get_open_error();
 #elif
-	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ, &err);
+		Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ, &err);
 #endif
-	if (err != OK) {
-		return err;
+		if (err != OK) {
+			return err;
+		}
+		bytes = file->get_buffer(file->get_length());
+		ERR_FAIL_COND_V_MSG((uint64_t)bytes.size() != file->get_length(), ERR_FILE_CORRUPT, vformat("Could not read saveload file %s.", p_path));
+	}
+	if (SaveloadCipher::is_encrypted(bytes)) {
+		PhaseTimer timer(this, PHASE_ENCRYPT);
+		SaveloadCipher cipher;
+		err = cipher.begin_decrypt(bytes, _get_option(p_configuration_data, "encryption_key", PackedByteArray()));
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not decrypt saveload file %s.", p_path));
+		_run_cipher(cipher, true);
+		err = cipher.finish(bytes);
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not decrypt saveload file %s.", p_path));
+	}
+	if (SaveloadChunkStore::is_manifest(bytes)) {
+		PhaseTimer timer(this, PHASE_READ);
+		PackedByteArray restored;
+		err = SaveloadChunkStore::restore(bytes, _get_option(p_configuration_data, "store_directory", String()), restored);
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not restore saveload file %s from its chunks.", p_path));
+		bytes = restored;
+	}
+	if (instrumentation_enabled) {
+		last_operation_stats.byte_count = bytes.size();
+	}
+	const bool has_magic = SaveloadDecoder::has_magic(bytes);
+	decode_arena.reset(); // Also reclaims what a load that failed part way left behind.
+	if (has_magic) {
+		PhaseTimer timer(this, PHASE_COMPRESS);
+		err = SaveloadDecoder::decompress(bytes);
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not decompress saveload file %s.", p_path));
+	}
+	SaveloadState saveload_state;
+	{
+		PhaseTimer timer(this, PHASE_DECODE);
+		if (has_magic) {
+			SaveloadDecoder decoder;
+			decoder.set_arena(&decode_arena);
+			decoder.set_allow_objects(_get_option(p_configuration_data, "allow_objects", false));
+			decoder.set_threaded_resources(_get_option(p_configuration_data, "threaded_resources", false));
+			err = decoder.decode(bytes, saveload_state);
+			ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not decode saveload file %s.", p_path));
+		} else {
+			// Files written before the binary format hold a single length-prefixed store_var Dictionary.
+			ERR_FAIL_COND_V_MSG(bytes.size() < 4, ERR_FILE_CORRUPT, vformat("Saveload file %s is truncated.", p_path));
+			saveload_state = SaveloadState(SaveloadDecoder::decode_variant(bytes.slice(4)));
+		}
+	}
+	err = load_saveload_state(saveload_state, _get_option(p_configuration_data, "threaded_apply", false), _get_option(p_configuration_data, "lazy_apply", false));
+	decode_arena.reset();
+	_end_operation(start);
+	return err;
+}
+
+Error SceneSaveload::validate(const String &p_path, const Variant &p_configuration_data) {
+	// Touches no member, so that slot lists can validate their files on other threads.
+	return SaveloadDecoder::validate(p_path, _get_option(p_configuration_data, "store_directory", String()), _get_option(p_configuration_data, "encryption_key", PackedByteArray()));
+}
+
+SceneSaveload::~SceneSaveload() {
+	// The save task writes through this object, so it must end first.
+	if (save_task_id >= 0) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(save_task_id);
+	}
+	if (!save_queue.is_empty()) {
+		WARN_PRINT(vformat("%d queued saves were discarded. Call flush_saves() before quitting to write them.", save_queue.size()));
+	}
+	if (instrumentation_enabled) {
+		_remove_monitors();
+	}
+	if (save_encoder) {
+		memdelete(save_encoder);
 	}
-	return deserialize(file->get_var(false));
 }
 
 void SceneSaveload::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_synchers"), &SceneSaveload::get_synchers);
 	ClassDB::bind_method(D_METHOD("get_spawners"), &SceneSaveload::get_spawners);
+
+	ClassDB::bind_method(D_METHOD("set_instrumentation_enabled", "enabled"), &SceneSaveload::set_instrumentation_enabled);
+	ClassDB::bind_method(D_METHOD("is_instrumentation_enabled"), &SceneSaveload::is_instrumentation_enabled);
+	ClassDB::bind_method(D_METHOD("get_last_operation_stats"), &SceneSaveload::get_last_operation_stats);
+
+	ClassDB::bind_method(D_METHOD("set_cost_diagnostics_enabled", "enabled"), &SceneSaveload::set_cost_diagnostics_enabled);
+	ClassDB::bind_method(D_METHOD("is_cost_diagnostics_enabled"), &SceneSaveload::is_cost_diagnostics_enabled);
+	ClassDB::bind_method(D_METHOD("get_cost_report", "top_n", "sort_by_time"), &SceneSaveload::get_cost_report, DEFVAL(10), DEFVAL(false));
+
+	ClassDB::bind_method(D_METHOD("add_migration", "migration"), &SceneSaveload::add_migration);
+	ClassDB::bind_method(D_METHOD("remove_migration", "migration"), &SceneSaveload::remove_migration);
+	ClassDB::bind_method(D_METHOD("apply_pending_states"), &SceneSaveload::apply_pending_states);
+
+	ClassDB::bind_method(D_METHOD("save_async", "path", "configuration_data"), &SceneSaveload::save_async, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("flush_saves"), &SceneSaveload::flush_saves);
+	ClassDB::bind_method(D_METHOD("get_save_queue_depth"), &SceneSaveload::get_save_queue_depth);
+	ClassDB::bind_method(D_METHOD("get_save_queue_bytes"), &SceneSaveload::get_save_queue_bytes);
+	ClassDB::bind_method(D_METHOD("set_save_queue_memory_limit", "bytes"), &SceneSaveload::set_save_queue_memory_limit);
+	ClassDB::bind_method(D_METHOD("get_save_queue_memory_limit"), &SceneSaveload::get_save_queue_memory_limit);
+	ClassDB::bind_method(D_METHOD("set_save_queue_policy", "policy"), &SceneSaveload::set_save_queue_policy);
+	ClassDB::bind_method(D_METHOD("get_save_queue_policy"), &SceneSaveload::get_save_queue_policy);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "instrumentation_enabled"), "set_instrumentation_enabled", "is_instrumentation_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cost_diagnostics_enabled"), "set_cost_diagnostics_enabled", "is_cost_diagnostics_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "save_queue_memory_limit", PROPERTY_HINT_RANGE, "0,1073741824,1,or_greater,suffix:B"), "set_save_queue_memory_limit", "get_save_queue_memory_limit");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "save_queue_policy", PROPERTY_HINT_ENUM, "Coalesce,Drop,Block"), "set_save_queue_policy", "get_save_queue_policy");
+
+	ADD_SIGNAL(MethodInfo("save_queue_changed", PropertyInfo(Variant::INT, "depth"), PropertyInfo(Variant::INT, "bytes")));
+	ADD_SIGNAL(MethodInfo("save_completed", PropertyInfo(Variant::STRING, "path"), PropertyInfo(Variant::INT, "error")));
+
+	BIND_ENUM_CONSTANT(SAVE_QUEUE_COALESCE);
+	BIND_ENUM_CONSTANT(SAVE_QUEUE_DROP);
+	BIND_ENUM_CONSTANT(SAVE_QUEUE_BLOCK);
 }
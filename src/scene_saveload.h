@@ -32,6 +32,9 @@
 #define SCENE_SAVELOAD_H
 
 #include "saveload_api.h"
+#include "saveload_arena.h"
+#include "saveload_cipher.h"
+#include "saveload_path_table.h"
 #include "saveload_spawner.h"
 #include "saveload_synchronizer.h"
 
@@ -41,37 +44,174 @@
 
 #endif
 
+class SaveloadEncoder;
+
 class SceneSaveload : public SaveloadAPI {
 GDCLASS(SceneSaveload, SaveloadAPI);
 
+    friend class SaveloadEncoder;
+    friend class SaveloadDecoder;
+    friend class SaveloadSpawner;
+    friend class SaveloadSynchronizer;
+
 private:
+    template<class T>
+    T *get_node(const NodePath &p_path);
 
-#ifdef GDEXTENSION
-    typedef uint64_t ID;
+    SaveloadPathTable path_table; // Backs SaveloadPathTable::get_singleton().
+    SaveloadArena decode_arena; // Reset at the end of every load, keeping its memory.
+
+    enum Phase {
+        PHASE_SNAPSHOT,
+        PHASE_ENCODE,
+        PHASE_COMPRESS,
+        PHASE_ENCRYPT,
+        PHASE_WRITE,
+        PHASE_READ,
+        PHASE_DECODE,
+        PHASE_SPAWN,
+        PHASE_APPLY,
+        PHASE_MAX,
+    };
 
-    template<class T>
-    static T *get_id_as(const ID &p_id) {
-        return UtilityFunctions::is_instance_id_valid(p_id) ? Object::cast_to<T>(ObjectDB::get_instance(p_id))
-                                                            : nullptr;
-    }
-
-#elif
-    typedef ObjectID ID;
-    template <class T>
-    static T *get_id_as(const ID &p_id) {
-        return p_id.is_valid() ? Object::cast_to<T>(ObjectDB::get_instance(p_id)) : nullptr;
-    }
-#endif
+    static const char *phase_names[PHASE_MAX];
 
-    template<class T>
-    T *get_node(const NodePath &p_path);
+    struct OperationStats {
+        String operation;
+        uint64_t phase_usec[PHASE_MAX] = {};
+        uint64_t total_usec = 0;
+        uint32_t spawner_count = 0;
+        uint32_t spawn_count = 0;
+        uint32_t syncher_count = 0;
+        uint32_t property_count = 0;
+        uint64_t byte_count = 0;
+        int64_t retained_bytes = 0; // Change in static memory usage across a save, debug builds only.
+        uint32_t scratch_allocations = 0; // Times a save had to grow its reusable buffers or sort keys.
+
+        void reset(const String &p_operation);
+
+        Dictionary to_dict() const;
+    };
+
+    // Accumulates the time spent in its scope into a phase of the current operation.
+    // Does nothing while instrumentation is disabled.
+    class PhaseTimer {
+        OperationStats *stats = nullptr;
+        Phase phase;
+        uint64_t start = 0;
+
+    public:
+        PhaseTimer(SceneSaveload *p_saveload, Phase p_phase);
+
+        ~PhaseTimer();
+    };
+
+    // Records how much more static memory is in use when its scope ends than when it began.
+    // Does nothing while instrumentation is disabled or in builds without memory tracking.
+    class MemoryProbe {
+        OperationStats *stats = nullptr;
+        uint64_t start = 0;
+
+    public:
+        MemoryProbe(SceneSaveload *p_saveload);
+
+        ~MemoryProbe();
+    };
+
+    bool instrumentation_enabled = false;
+    OperationStats last_operation_stats;
+
+    struct CostEntry {
+        String name;
+        String config;
+        uint64_t bytes = 0;
+        uint64_t nsec = 0;
+        uint32_t count = 0;
+    };
+
+    struct CostEntryByBytes {
+        _FORCE_INLINE_ bool operator()(const CostEntry &p_a, const CostEntry &p_b) const {
+            return p_a.bytes != p_b.bytes ? p_a.bytes > p_b.bytes : p_a.nsec > p_b.nsec;
+        }
+    };
+
+    struct CostEntryByTime {
+        _FORCE_INLINE_ bool operator()(const CostEntry &p_a, const CostEntry &p_b) const {
+            return p_a.nsec != p_b.nsec ? p_a.nsec > p_b.nsec : p_a.bytes > p_b.bytes;
+        }
+    };
+
+    // Costs attributed during the last snapshot taken with cost diagnostics enabled.
+    struct CostReport {
+        HashMap<String, CostEntry> synchers;
+        HashMap<String, CostEntry> configs;
+        HashMap<String, CostEntry> properties;
+
+        void clear();
+    };
+
+    bool cost_diagnostics_enabled = false;
+    CostReport cost_report;
+
+    static String _get_config_name(const Ref<SceneSaveloadConfig> &p_config);
+
+    static Array _sorted_costs(const HashMap<String, CostEntry> &p_entries, int p_top_n, bool p_by_time);
+
+    static uint64_t get_ticks_usec();
+    // Single property reads often take well under a microsecond, so cost diagnostics time them
+    // with a nanosecond clock.
+    static uint64_t get_ticks_nsec();
+
+    // configuration_data is an optional Dictionary of options, see the class documentation.
+    static Variant _get_option(const Variant &p_configuration_data, const String &p_key, const Variant &p_default);
+
+    void _begin_operation(const String &p_operation);
+
+    void _end_operation(uint64_t p_start_usec);
+
+    void _add_monitors();
+
+    void _remove_monitors();
+
+    Variant _get_monitor_value(int p_monitor) const;
 
 protected:
     static void _bind_methods();
 
+    // State of every synchronizer sharing one SceneSaveloadConfig, stored column by column
+    // so the property paths are kept once per group rather than once per synchronizer.
+    struct SyncherGroup {
+        Ref<SceneSaveloadConfig> config; // Only set on captured groups.
+        LocalVector<uint32_t> properties; // Path IDs.
+        LocalVector<uint32_t> synchers; // Path IDs.
+        LocalVector<LocalVector<Variant>> columns; // columns[property][syncher]
+        LocalVector<bool> thread_safe; // Only set on captured groups: whether each property may be read by worker threads.
+        uint64_t fingerprint = 0; // Schema fingerprint of the config when saved, 0 if the save predates them.
+        // missing[property][syncher] is set where the property could not be read, so loading leaves it
+        // as it is rather than writing the null in its column. Groups without any can leave it empty.
+        LocalVector<LocalVector<uint8_t>> missing;
+
+        _FORCE_INLINE_ bool is_missing(uint32_t p_property, uint32_t p_instance) const {
+            return p_property < missing.size() && p_instance < missing[p_property].size() && missing[p_property][p_instance];
+        }
+
+        // Sizes missing like columns, for captures and decoders to set each synchronizer's flags.
+        void resize_missing();
+
+        uint32_t add_syncher(uint32_t p_path_id);
+
+        SyncherGroup() {}
+
+        SyncherGroup(const LocalVector<uint32_t> &p_properties);
+    };
+
     struct SaveloadState {
-        HashMap<const NodePath, SaveloadSpawner::SpawnerState> spawner_states;
-        HashMap<const NodePath, SaveloadSynchronizer::SyncherState> syncher_states;
+        HashMap<uint32_t, SaveloadSpawner::SpawnerState> spawner_states; // Keyed by path ID.
+        LocalVector<SyncherGroup> syncher_groups;
+        HashMap<uint64_t, uint32_t> config_groups; // Config instance ID to group, for captures.
+
+        // Drops the captured values but keeps the memory holding them, for the next capture.
+        void release_values();
 
         Dictionary to_dict() const;
 
@@ -80,22 +220,250 @@ protected:
         SaveloadState(const Dictionary &saveload_dict);
     };
 
-    HashSet<ID> spawners;
-    HashSet<ID> synchers;
+    // Tracked nodes, in no particular order. Each node stores its own index, so both
+    // tracking and untracking are O(1); nodes untrack themselves before they are freed.
+    LocalVector<SaveloadSpawner *> spawners;
+    LocalVector<SaveloadSynchronizer *> synchers;
+
+    void track_spawner(SaveloadSpawner &p_spawner);
+
+    void untrack_spawner(SaveloadSpawner &p_spawner);
+
+    void track_syncher(SaveloadSynchronizer &p_syncher);
+
+    void untrack_syncher(SaveloadSynchronizer &p_syncher);
+
+    // Path IDs are held by the tracked nodes and save_state, which _collect_paths() marks, and
+    // by states being captured, decoded or applied, which it cannot see. Operations using such a
+    // state take a PathHold, and paths are only collected while none is taken.
+    uint32_t path_holds = 0;
+
+    struct PathHold {
+        SceneSaveload *saveload = nullptr;
+
+        PathHold(SceneSaveload *p_saveload);
+
+        ~PathHold();
+    };
+
+    static void _mark_paths(SaveloadPathTable &r_paths, const SaveloadState &p_saveload_state);
+
+    // Frees the interned paths nothing holds any more, once enough have been interned.
+    void _collect_paths();
+
+    // Sorts tracked nodes by path, so that capturing the same scene always yields the
+    // same group, instance and spawner order, and so the same bytes.
+    void _sort_tracked();
+
+    // Sort keys of the tracked nodes as of the last _sort_tracked(), in the order it left them.
+    // Their path IDs are kept from collection, so an unchanged ID still means an unchanged path.
+    struct SortEntry {
+        String path;
+        uint32_t path_id = SaveloadPathTable::INVALID_ID;
+        void *node = nullptr;
+
+        bool operator<(const SortEntry &p_other) const { return path < p_other.path; }
+    };
+
+    LocalVector<SortEntry> spawner_sort_entries;
+    LocalVector<SortEntry> syncher_sort_entries;
 
-    void track_spawner(const SaveloadSpawner &p_spawner);
+    // Returns the sort keys it had to build, plus one if the entries grew, so zero while the same
+    // nodes keep the same paths.
+    template <typename T>
+    static uint32_t _sort_by_path(LocalVector<T *> &r_nodes, LocalVector<SortEntry> &r_entries, SaveloadPathTable &r_paths);
 
-    void untrack_spawner(const SaveloadSpawner &p_spawner);
+    enum {
+        TASK_BATCH_SIZE = 128, // Synchronizers handled per worker thread task.
+    };
+
+    // Runs p_method once per index on the WorkerThreadPool and waits for all of them.
+    void _run_group_task(void (SceneSaveload::*p_method)(uint32_t), uint32_t p_elements, const String &p_description);
+
+    struct TaskBatch {
+        uint32_t group = 0;
+        uint32_t begin = 0;
+        uint32_t end = 0;
+    };
+
+    // Work shared with the capture tasks. Objects are resolved on the main thread, so the
+    // tasks only call getters and each writes to its own preallocated slots in the columns.
+    struct CaptureJob {
+        SaveloadState *state = nullptr;
+        LocalVector<LocalVector<uint32_t>> properties; // Per group, the properties read by tasks.
+        LocalVector<LocalVector<LocalVector<const Object *>>> targets; // Per group, [task property][syncher].
+        LocalVector<TaskBatch> batches;
+
+        void clear();
+    };
+
+    CaptureJob capture_job;
+
+    void _capture_batch(uint32_t p_batch);
+
+    // Work shared with the apply tasks: one run of consecutive thread-safe properties of a group,
+    // with their objects resolved on the main thread. Runs of other properties are set on the
+    // main thread in between, so each node still has its properties set in order.
+    struct ApplyJob {
+        const SyncherGroup *group = nullptr;
+        uint32_t property_begin = 0;
+        LocalVector<LocalVector<Object *>> targets; // [property - property_begin][syncher].
+        LocalVector<TaskBatch> batches;
+
+        void clear();
+    };
+
+    ApplyJob apply_job;
+    LocalVector<uint8_t> apply_property_exists; // Per property of the group being applied, see _find_apply_properties().
+
+    void _find_apply_properties(const SyncherGroup &p_group, Node *p_root_node);
+
+    void _apply_batch(uint32_t p_batch);
+
+    void _apply_threaded(const SaveloadState &p_saveload_state);
+
+    SaveloadState get_saveload_state(bool p_threaded = false, SceneSaveloadConfig::SaveTier p_tier = SceneSaveloadConfig::TIER_COLD);
+
+    // Captures into p_saveload_state, reusing the groups and columns of an earlier capture.
+    void get_saveload_state(SaveloadState &r_saveload_state, bool p_threaded = false, SceneSaveloadConfig::SaveTier p_tier = SceneSaveloadConfig::TIER_COLD);
+
+    // Capture scratch, kept across saves so steady-state autosaves do not allocate.
+    LocalVector<uint32_t> capture_properties;
+    LocalVector<bool> capture_thread_safe;
+    LocalVector<uint32_t> capture_group_order; // Groups in the order their configs were first met.
+    LocalVector<LocalVector<uint8_t>> capture_property_exists; // Per group, see _begin_capture_group().
+    LocalVector<uint64_t> capture_property_nsec;
+    SaveloadState save_state;
+    SaveloadEncoder *save_encoder = nullptr;
+
+    void _begin_capture_group(SyncherGroup &r_group, const Ref<SceneSaveloadConfig> &p_config, const Node *p_root_node, uint32_t p_group_index, bool p_threaded, SceneSaveloadConfig::SaveTier p_tier);
+
+    void _count_state(const SaveloadState &p_saveload_state);
+
+    void _record_costs(const SyncherGroup &p_group, uint32_t p_instance, const LocalVector<uint64_t> &p_property_nsec, uint64_t p_syncher_nsec);
+
+    // Version of the Dictionary made by serialize(), bumped whenever its layout changes.
+    static const int STATE_VERSION = 1;
+
+    LocalVector<Callable> migrations;
+
+    // Runs the migrations on each group saved with a different schema than its config has now.
+    void _migrate(SaveloadState &r_saveload_state);
+
+    // Moves the values of disabled synchronizers out of the state and into their pending state.
+    void _defer_disabled(SaveloadState &r_saveload_state);
+
+    Error load_saveload_state(SaveloadState &r_saveload_state, bool p_threaded = false, bool p_lazy = false);
+
+    // Captures and encodes the tracked nodes for a save, leaving compression and writing to the caller.
+    Error _encode_save(PackedByteArray &r_bytes, const Variant &p_configuration_data);
+
+    // Whether the file at p_path already holds p_bytes, for canonical saves.
+    bool _is_saved(const String &p_path, const PackedByteArray &p_bytes, int p_compression);
+
+    // How an encoded save becomes the file on disk, read from configuration_data.
+    struct WriteOptions {
+        int compression = 0;
+        String store_directory;
+        PackedByteArray encryption_key;
+        bool uncached = false;
+    };
+
+    static Error _get_write_options(const Variant &p_configuration_data, WriteOptions &r_options);
+
+    // Compresses or chunks r_bytes, encrypts them and writes them to p_path. Also runs on the save
+    // task, where p_main_thread is false and neither phase timers nor group tasks are used.
+    Error _write_save(const String &p_path, PackedByteArray &r_bytes, const WriteOptions &p_options, bool p_main_thread, uint64_t &r_chunk_bytes);
 
-    void track_syncher(const SaveloadSynchronizer &p_syncher);
+    SaveloadCipher *cipher_job = nullptr; // Shared with the cipher tasks while they run.
 
-    void untrack_syncher(const SaveloadSynchronizer &p_syncher);
+    void _cipher_block(uint32_t p_block);
 
-    SaveloadState get_saveload_state() const;
+    // Encrypts or decrypts every block of p_cipher, on the WorkerThreadPool if p_threaded.
+    void _run_cipher(SaveloadCipher &p_cipher, bool p_threaded);
 
-    Error load_saveload_state(const SaveloadState &p_saveload_state);
+public:
+    // What save_async() does when a save would take the queue past its memory limit.
+    enum SaveQueuePolicy {
+        SAVE_QUEUE_COALESCE, // Replace queued saves to the same path, then reject if still over.
+        SAVE_QUEUE_DROP, // Reject the new save.
+        SAVE_QUEUE_BLOCK, // Wait for queued saves to be written until the new one fits.
+        SAVE_QUEUE_POLICY_MAX,
+    };
+
+private:
+    // An encoded save waiting to be compressed and written by the save task.
+    struct QueuedSave {
+        String path;
+        PackedByteArray bytes;
+        uint64_t size = 0; // Encoded size, counted against the memory limit until the write ends.
+        WriteOptions options;
+        Error error = OK;
+    };
+
+    // Saves are written one at a time, in request order. Only the main thread touches the
+    // queue; the save task only touches active_save, and only while it runs.
+    LocalVector<QueuedSave> save_queue;
+    QueuedSave active_save;
+    int64_t save_task_id = -1;
+    uint64_t queued_save_bytes = 0; // Held by save_queue and active_save.
+    uint64_t save_queue_memory_limit = 64 * 1024 * 1024;
+    SaveQueuePolicy save_queue_policy = SAVE_QUEUE_COALESCE;
+
+    void _write_active_save();
+
+    void _start_next_save();
+
+    // Waits for the save task, reports its result and starts the next queued save.
+    void _finish_active_save();
+
+    void _poll_save_queue();
+
+    bool _is_save_pending(const String &p_path) const;
+
+    uint32_t _drop_queued_saves(const String &p_path);
+
+    void _set_save_queue_processing(bool p_processing);
+
+    void _emit_save_queue_changed();
 
 public:
+    void set_instrumentation_enabled(bool p_enabled);
+
+    bool is_instrumentation_enabled() const;
+
+    Dictionary get_last_operation_stats() const;
+
+    void set_cost_diagnostics_enabled(bool p_enabled);
+
+    bool is_cost_diagnostics_enabled() const;
+
+    Dictionary get_cost_report(int p_top_n = 10, bool p_sort_by_time = false) const;
+
+    void set_save_queue_memory_limit(int64_t p_bytes);
+
+    int64_t get_save_queue_memory_limit() const;
+
+    void set_save_queue_policy(SaveQueuePolicy p_policy);
+
+    SaveQueuePolicy get_save_queue_policy() const;
+
+    int get_save_queue_depth() const;
+
+    int64_t get_save_queue_bytes() const;
+
+    Error save_async(const String &p_path, const Variant &p_configuration_data = Variant());
+
+    // Blocks until every queued save is written.
+    void flush_saves();
+
+    void add_migration(const Callable &p_migration);
+
+    void remove_migration(const Callable &p_migration);
+
+    // Sets every state a lazy load kept for a disabled synchronizer.
+    void apply_pending_states();
+
     TypedArray<SaveloadSpawner> get_spawners() const;
 
     TypedArray<SaveloadSynchronizer> get_synchers() const;
@@ -112,9 +480,13 @@ public:
 
     Error load(const String &p_path, const Variant &p_configuration_data = Variant()) override;
 
+    Error validate(const String &p_path, const Variant &p_configuration_data = Variant()) override;
+
     SceneSaveload() {}
 
-    ~SceneSaveload() {}
+    ~SceneSaveload();
 };
 
+VARIANT_ENUM_CAST(SceneSaveload::SaveQueuePolicy);
+
 #endif // SCENE_SAVELOAD_H
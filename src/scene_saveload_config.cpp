@@ -57,9 +57,37 @@ bool SceneSaveloadConfig::_set(const StringName &p_name, const Variant &p_value)
 			add_property(path);
 			return true;
 		}
-		ERR_FAIL_COND_V(p_value.get_type() != Variant::BOOL, false);
 		ERR_FAIL_INDEX_V(idx, properties.size(), false);
 		SaveloadProperty &prop = properties[idx];
+		if (what == "type") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::INT, false);
+			ERR_FAIL_INDEX_V((int)p_value, Variant::VARIANT_MAX, false);
+			prop.type = (Variant::Type)(int)p_value;
+			return true;
+		}
+		if (what == "encoding") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::INT, false);
+			ERR_FAIL_INDEX_V((int)p_value, ENCODING_MAX, false);
+			prop.encoding = (PropertyEncoding)(int)p_value;
+			return true;
+		}
+		if (what == "tier") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::INT, false);
+			ERR_FAIL_INDEX_V((int)p_value, TIER_MAX, false);
+			prop.tier = (SaveTier)(int)p_value;
+			return true;
+		}
+		if (what == "encoding_range") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::VECTOR2, false);
+			ERR_FAIL_COND_V_MSG(!is_valid_encoding_range(p_value), false, "Encoding range must be finite, with its minimum less than its maximum.");
+			prop.encoding_range = p_value;
+			return true;
+		}
+		ERR_FAIL_COND_V(p_value.get_type() != Variant::BOOL, false);
+		if (what == "thread_safe") {
+			prop.thread_safe = p_value;
+			return true;
+		}
 		if (what == "sync") {
 			if ((bool)p_value == prop.sync) {
 				return true;
@@ -70,6 +98,7 @@ bool SceneSaveloadConfig::_set(const StringName &p_name, const Variant &p_value)
 			} else {
 				sync_props.erase(prop.name);
 			}
+			_update_schema_fingerprint();
 			return true;
 		}
 	}
@@ -90,6 +119,21 @@ bool SceneSaveloadConfig::_get(const StringName &p_name, Variant &r_ret) const {
 		} else if (what == "sync") {
 			r_ret = prop.sync;
 			return true;
+		} else if (what == "type") {
+			r_ret = prop.type;
+			return true;
+		} else if (what == "encoding") {
+			r_ret = prop.encoding;
+			return true;
+		} else if (what == "encoding_range") {
+			r_ret = prop.encoding_range;
+			return true;
+		} else if (what == "thread_safe") {
+			r_ret = prop.thread_safe;
+			return true;
+		} else if (what == "tier") {
+			r_ret = prop.tier;
+			return true;
 		}
 	}
 	return false;
@@ -99,6 +143,11 @@ void SceneSaveloadConfig::_get_property_list(List<PropertyInfo> *p_list) const {
 	for (int i = 0; i < properties.size(); i++) {
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/sync", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/type", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/encoding", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::VECTOR2, "properties/" + itos(i) + "/encoding_range", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::BOOL, "properties/" + itos(i) + "/thread_safe", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/tier", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 	}
 }
 
@@ -116,6 +165,7 @@ void SceneSaveloadConfig::add_property(const NodePath &p_path, int p_index) {
 	if (p_index < 0 || p_index == properties.size()) {
 		properties.push_back(SaveloadProperty(p_path));
 		sync_props.push_back(p_path);
+		_update_schema_fingerprint();
 		return;
 	}
 
@@ -134,11 +184,13 @@ void SceneSaveloadConfig::add_property(const NodePath &p_path, int p_index) {
 			sync_props.push_back(prop.name);
 		}
 	}
+	_update_schema_fingerprint();
 }
 
 void SceneSaveloadConfig::remove_property(const NodePath &p_path) {
 	properties.erase(p_path);
 	sync_props.erase(p_path);
+	_update_schema_fingerprint();
 }
 
 bool SceneSaveloadConfig::has_property(const NodePath &p_path) const {
@@ -178,6 +230,99 @@ void SceneSaveloadConfig::property_set_sync(const NodePath &p_path, bool p_enabl
 			sync_props.push_back(prop.name);
 		}
 	}
+	_update_schema_fingerprint();
+}
+
+Variant::Type SceneSaveloadConfig::property_get_type(const NodePath &p_path) const {
+	for (const SaveloadProperty &prop : properties) {
+		if (prop.name == p_path) {
+			return prop.type;
+		}
+	}
+	ERR_FAIL_V(Variant::NIL);
+}
+
+void SceneSaveloadConfig::property_set_type(const NodePath &p_path, Variant::Type p_type) {
+	ERR_FAIL_INDEX(p_type, Variant::VARIANT_MAX);
+	List<SaveloadProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	E->get().type = p_type;
+}
+
+SceneSaveloadConfig::PropertyEncoding SceneSaveloadConfig::property_get_encoding(const NodePath &p_path) const {
+	for (const SaveloadProperty &prop : properties) {
+		if (prop.name == p_path) {
+			return prop.encoding;
+		}
+	}
+	ERR_FAIL_V(ENCODING_DEFAULT);
+}
+
+void SceneSaveloadConfig::property_set_encoding(const NodePath &p_path, PropertyEncoding p_encoding) {
+	ERR_FAIL_INDEX(p_encoding, ENCODING_MAX);
+	List<SaveloadProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	E->get().encoding = p_encoding;
+}
+
+Vector2 SceneSaveloadConfig::property_get_encoding_range(const NodePath &p_path) const {
+	for (const SaveloadProperty &prop : properties) {
+		if (prop.name == p_path) {
+			return prop.encoding_range;
+		}
+	}
+	ERR_FAIL_V(Vector2());
+}
+
+void SceneSaveloadConfig::property_set_encoding_range(const NodePath &p_path, const Vector2 &p_range) {
+	ERR_FAIL_COND_MSG(!is_valid_encoding_range(p_range), "Encoding range must be finite, with its minimum less than its maximum.");
+	List<SaveloadProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	E->get().encoding_range = p_range;
+}
+
+bool SceneSaveloadConfig::property_get_thread_safe(const NodePath &p_path) const {
+	for (const SaveloadProperty &prop : properties) {
+		if (prop.name == p_path) {
+			return prop.thread_safe;
+		}
+	}
+	ERR_FAIL_V(false);
+}
+
+void SceneSaveloadConfig::property_set_thread_safe(const NodePath &p_path, bool p_thread_safe) {
+	List<SaveloadProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	E->get().thread_safe = p_thread_safe;
+}
+
+SceneSaveloadConfig::SaveTier SceneSaveloadConfig::property_get_tier(const NodePath &p_path) const {
+	for (const SaveloadProperty &prop : properties) {
+		if (prop.name == p_path) {
+			return prop.tier;
+		}
+	}
+	ERR_FAIL_V(TIER_CRITICAL);
+}
+
+void SceneSaveloadConfig::property_set_tier(const NodePath &p_path, SaveTier p_tier) {
+	ERR_FAIL_INDEX(p_tier, TIER_MAX);
+	List<SaveloadProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	E->get().tier = p_tier;
+}
+
+void SceneSaveloadConfig::_update_schema_fingerprint() {
+	// 64-bit FNV-1a over the paths in save order, each with its terminator so that paths cannot run together.
+	uint64_t hash = 0xCBF29CE484222325;
+	for (const NodePath &path : sync_props) {
+		const CharString utf8 = String(path).utf8();
+		const uint8_t *data = (const uint8_t *)utf8.get_data();
+		for (int i = 0; i <= utf8.length(); i++) {
+			hash = (hash ^ data[i]) * 0x100000001B3;
+		}
+	}
+	schema_fingerprint = hash;
 }
 
 void SceneSaveloadConfig::_bind_methods() {
@@ -188,4 +333,25 @@ void SceneSaveloadConfig::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("property_get_index", "path"), &SceneSaveloadConfig::property_get_index);
 	ClassDB::bind_method(D_METHOD("property_get_sync", "path"), &SceneSaveloadConfig::property_get_sync);
 	ClassDB::bind_method(D_METHOD("property_set_sync", "path", "enabled"), &SceneSaveloadConfig::property_set_sync);
+	ClassDB::bind_method(D_METHOD("property_get_type", "path"), &SceneSaveloadConfig::property_get_type);
+	ClassDB::bind_method(D_METHOD("property_set_type", "path", "type"), &SceneSaveloadConfig::property_set_type);
+	ClassDB::bind_method(D_METHOD("property_get_encoding", "path"), &SceneSaveloadConfig::property_get_encoding);
+	ClassDB::bind_method(D_METHOD("property_set_encoding", "path", "encoding"), &SceneSaveloadConfig::property_set_encoding);
+	ClassDB::bind_method(D_METHOD("property_get_encoding_range", "path"), &SceneSaveloadConfig::property_get_encoding_range);
+	ClassDB::bind_method(D_METHOD("property_set_encoding_range", "path", "range"), &SceneSaveloadConfig::property_set_encoding_range);
+	ClassDB::bind_method(D_METHOD("property_get_thread_safe", "path"), &SceneSaveloadConfig::property_get_thread_safe);
+	ClassDB::bind_method(D_METHOD("property_set_thread_safe", "path", "thread_safe"), &SceneSaveloadConfig::property_set_thread_safe);
+	ClassDB::bind_method(D_METHOD("property_get_tier", "path"), &SceneSaveloadConfig::property_get_tier);
+	ClassDB::bind_method(D_METHOD("property_set_tier", "path", "tier"), &SceneSaveloadConfig::property_set_tier);
+	ClassDB::bind_method(D_METHOD("get_schema_fingerprint"), &SceneSaveloadConfig::get_schema_fingerprint);
+
+	BIND_ENUM_CONSTANT(ENCODING_DEFAULT);
+	BIND_ENUM_CONSTANT(ENCODING_HALF);
+	BIND_ENUM_CONSTANT(ENCODING_FIXED_16);
+	BIND_ENUM_CONSTANT(ENCODING_SMALLEST_THREE);
+	BIND_ENUM_CONSTANT(ENCODING_COLOR_BYTE);
+
+	BIND_ENUM_CONSTANT(TIER_CRITICAL);
+	BIND_ENUM_CONSTANT(TIER_NORMAL);
+	BIND_ENUM_CONSTANT(TIER_COLD);
 }
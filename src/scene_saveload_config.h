@@ -50,10 +50,35 @@ class SceneSaveloadConfig : public Resource {
 //	OBJ_SAVE_TYPE(SceneSaveloadConfig);
 //	RES_BASE_EXTENSION("svldcfg");
 
+public:
+	// How a property's value is written by the binary save format. Lossy encodings
+	// only apply to the types listed next to them and fall back to full precision otherwise.
+	enum PropertyEncoding {
+		ENCODING_DEFAULT, // Full precision.
+		ENCODING_HALF, // float, Vector2, Vector3, Quaternion, Transform3D components as 16-bit floats.
+		ENCODING_FIXED_16, // float, Vector2, Vector3 components as 16-bit fixed point within the encoding range.
+		ENCODING_SMALLEST_THREE, // Quaternion as 32 bits: index of the largest component and the other three in 10 bits each.
+		ENCODING_COLOR_BYTE, // Color as one normalized byte per channel.
+		ENCODING_MAX,
+	};
+
+	// Which saves capture a property. Each tier is also captured by the saves of every tier above it.
+	enum SaveTier {
+		TIER_CRITICAL, // Every save, including frequent autosaves.
+		TIER_NORMAL, // Manual saves and regular autosaves.
+		TIER_COLD, // Full saves only, such as on leaving a level.
+		TIER_MAX,
+	};
+
 private:
 	struct SaveloadProperty {
 		NodePath name;
 		bool sync = true;
+		Variant::Type type = Variant::NIL;
+		PropertyEncoding encoding = ENCODING_DEFAULT;
+		Vector2 encoding_range = Vector2(0, 1);
+		bool thread_safe = false; // Whether its getter and setter may run on worker threads.
+		SaveTier tier = TIER_CRITICAL;
 
 		bool operator==(const SaveloadProperty &p_to) {
 			return name == p_to.name;
@@ -68,6 +93,10 @@ private:
 
 	List<SaveloadProperty> properties;
 	List<NodePath> sync_props;
+	uint64_t schema_fingerprint = 0;
+
+	// Hashes the saved property paths, which is all that decides how a save maps onto nodes.
+	void _update_schema_fingerprint();
 
 protected:
 	static void _bind_methods();
@@ -88,9 +117,34 @@ public:
 	bool property_get_sync(const NodePath &p_path);
 	void property_set_sync(const NodePath &p_path, bool p_enabled);
 
+	Variant::Type property_get_type(const NodePath &p_path) const;
+	void property_set_type(const NodePath &p_path, Variant::Type p_type);
+
+	PropertyEncoding property_get_encoding(const NodePath &p_path) const;
+	void property_set_encoding(const NodePath &p_path, PropertyEncoding p_encoding);
+
+	// A fixed-point range needs finite bounds with min < max, or encoding it divides by zero.
+	static bool is_valid_encoding_range(const Vector2 &p_range) {
+		return Math::is_finite(p_range.x) && Math::is_finite(p_range.y) && p_range.x < p_range.y;
+	}
+
+	Vector2 property_get_encoding_range(const NodePath &p_path) const;
+	void property_set_encoding_range(const NodePath &p_path, const Vector2 &p_range);
+
+	bool property_get_thread_safe(const NodePath &p_path) const;
+	void property_set_thread_safe(const NodePath &p_path, bool p_thread_safe);
+
+	SaveTier property_get_tier(const NodePath &p_path) const;
+	void property_set_tier(const NodePath &p_path, SaveTier p_tier);
+
 	const List<NodePath> &get_sync_properties() { return sync_props; }
 
-	SceneSaveloadConfig() {}
+	uint64_t get_schema_fingerprint() const { return schema_fingerprint; }
+
+	SceneSaveloadConfig() { _update_schema_fingerprint(); }
 };
 
+VARIANT_ENUM_CAST(SceneSaveloadConfig::PropertyEncoding);
+VARIANT_ENUM_CAST(SceneSaveloadConfig::SaveTier);
+
 #endif // SCENE_SAVELOAD_CONFIG_H
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/*  test_saveload_arena.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SAVELOAD_ARENA_H
+#define TEST_SAVELOAD_ARENA_H
+
+#include "../src/saveload_arena.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSaveloadArena {
+
+TEST_CASE("[Saveload][Arena] Allocations are aligned and reused after a reset") {
+	SaveloadArena arena;
+	uint8_t *bytes = arena.alloc_array<uint8_t>(3);
+	REQUIRE(bytes);
+	uint64_t *words = arena.alloc_array<uint64_t>(4);
+	REQUIRE(words);
+	CHECK((uintptr_t)words % alignof(uint64_t) == 0);
+	CHECK((uint8_t *)words >= bytes + 3);
+
+	// Larger than a block, so it gets one of its own.
+	uint8_t *large = arena.alloc_array<uint8_t>(SaveloadArena::MIN_BLOCK_SIZE * 2);
+	REQUIRE(large);
+	large[SaveloadArena::MIN_BLOCK_SIZE * 2 - 1] = 1;
+
+	arena.reset();
+	const uint64_t capacity = arena.get_capacity();
+	CHECK(capacity >= SaveloadArena::MIN_BLOCK_SIZE * 2);
+	CHECK(arena.alloc_array<uint8_t>(SaveloadArena::MIN_BLOCK_SIZE * 2));
+	CHECK(arena.get_capacity() == capacity);
+}
+
+TEST_CASE("[Saveload][Arena] Sizes that would wrap around are rejected") {
+	SaveloadArena arena;
+	ERR_PRINT_OFF;
+	CHECK(arena.alloc(UINT32_MAX) == nullptr);
+	CHECK(arena.alloc(UINT32_MAX - SaveloadArena::DEFAULT_ALIGNMENT + 1) == nullptr);
+	CHECK(arena.alloc_array<uint32_t>(UINT32_MAX / sizeof(uint32_t) + 1) == nullptr);
+	CHECK(arena.alloc_array<uint64_t>(UINT32_MAX) == nullptr);
+	ERR_PRINT_ON;
+	CHECK(arena.get_capacity() == 0);
+}
+
+} // namespace TestSaveloadArena
+
+#endif // TEST_SAVELOAD_ARENA_H
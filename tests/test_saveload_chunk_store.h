@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*  test_saveload_chunk_store.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SAVELOAD_CHUNK_STORE_H
+#define TEST_SAVELOAD_CHUNK_STORE_H
+
+#include "../src/saveload_chunk_store.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestSaveloadChunkStore {
+
+// Bytes without repeats, so every chunk is distinct and the first store writes all of them.
+static PackedByteArray make_bytes(int64_t p_size) {
+	PackedByteArray bytes;
+	bytes.resize(p_size);
+	uint8_t *w = bytes.ptrw();
+	uint32_t state = 12345;
+	for (int64_t i = 0; i < p_size; i++) {
+		state = state * 1664525 + 1013904223;
+		w[i] = state >> 24;
+	}
+	return bytes;
+}
+
+// A fresh directory, as chunks left by an earlier run would already count as stored.
+static String make_directory(const String &p_name) {
+	const String directory = TestUtils::get_temp_path(p_name);
+	for (const String &file : DirAccess::get_files_at(directory)) {
+		DirAccess::remove_absolute(directory.path_join(file));
+	}
+	return directory;
+}
+
+TEST_CASE("[Saveload][ChunkStore] Restoring returns the stored bytes") {
+	const PackedByteArray bytes = make_bytes(256 * 1024);
+	const int compressions[] = { -1, FileAccess::COMPRESSION_ZSTD };
+	for (const int compression : compressions) {
+		CAPTURE(compression);
+		const String directory = make_directory("saveload_chunks");
+		PackedByteArray manifest;
+		uint64_t written = 0;
+		REQUIRE(SaveloadChunkStore::store(bytes, directory, compression, manifest, written) == OK);
+		CHECK(SaveloadChunkStore::is_manifest(manifest));
+		CHECK(!SaveloadChunkStore::is_manifest(bytes));
+		CHECK(written == (uint64_t)bytes.size());
+
+		PackedByteArray restored;
+		REQUIRE(SaveloadChunkStore::restore(manifest, String(), restored) == OK);
+		CHECK(restored == bytes);
+
+		// Storing the same bytes again writes nothing and lists the same chunks.
+		PackedByteArray again;
+		REQUIRE(SaveloadChunkStore::store(bytes, directory, compression, again, written) == OK);
+		CHECK(written == 0);
+		CHECK(again == manifest);
+
+		// A small edit only rewrites the chunks around it.
+		PackedByteArray edited = bytes;
+		edited.set(bytes.size() / 2, edited[bytes.size() / 2] ^ 1);
+		REQUIRE(SaveloadChunkStore::store(edited, directory, compression, manifest, written) == OK);
+		CHECK(written > 0);
+		CHECK(written <= 2 * SaveloadChunkStore::MAX_CHUNK_SIZE);
+		REQUIRE(SaveloadChunkStore::restore(manifest, directory, restored) == OK);
+		CHECK(restored == edited);
+	}
+}
+
+TEST_CASE("[Saveload][ChunkStore] Damaged chunks and manifests are rejected") {
+	const PackedByteArray bytes = make_bytes(64 * 1024);
+	const String directory = make_directory("saveload_chunks_damaged");
+	PackedByteArray manifest;
+	uint64_t written = 0;
+	REQUIRE(SaveloadChunkStore::store(bytes, directory, -1, manifest, written) == OK);
+	PackedByteArray restored;
+	ERR_PRINT_OFF;
+
+	SUBCASE("Wrong total size") {
+		PackedByteArray corrupt = manifest;
+		corrupt.set(9, corrupt[9] ^ 1); // The low byte of the total size.
+		CHECK(SaveloadChunkStore::restore(corrupt, String(), restored) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Truncated manifest") {
+		CHECK(SaveloadChunkStore::restore(manifest.slice(0, manifest.size() - 1), String(), restored) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Changed chunk") {
+		const PackedStringArray files = DirAccess::get_files_at(directory);
+		REQUIRE(files.size() > 0);
+		const String path = directory.path_join(files[0]);
+		PackedByteArray chunk = FileAccess::get_file_as_bytes(path);
+		REQUIRE(chunk.size() > 0);
+		chunk.set(0, chunk[0] ^ 1);
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(file.is_valid());
+		file->store_buffer(chunk.ptr(), chunk.size());
+		file.unref();
+		CHECK(SaveloadChunkStore::restore(manifest, String(), restored) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Missing chunks") {
+		CHECK(SaveloadChunkStore::restore(manifest, make_directory("saveload_chunks_empty"), restored) == ERR_FILE_NOT_FOUND);
+	}
+
+	ERR_PRINT_ON;
+}
+
+} // namespace TestSaveloadChunkStore
+
+#endif // TEST_SAVELOAD_CHUNK_STORE_H
@@ -0,0 +1,147 @@
+/**************************************************************************/
+/*  test_saveload_cipher.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SAVELOAD_CIPHER_H
+#define TEST_SAVELOAD_CIPHER_H
+
+#include "../src/saveload_cipher.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSaveloadCipher {
+
+// Two full blocks and a partial one, so blocks can be both reordered and truncated.
+static PackedByteArray make_plaintext() {
+	PackedByteArray bytes;
+	bytes.resize(SaveloadCipher::BLOCK_SIZE * 2 + 100);
+	uint8_t *w = bytes.ptrw();
+	for (int64_t i = 0; i < bytes.size(); i++) {
+		w[i] = (i * 31) >> 3;
+	}
+	return bytes;
+}
+
+static PackedByteArray make_key(const char *p_key) {
+	return String(p_key).to_utf8_buffer();
+}
+
+static Error encrypt(const PackedByteArray &p_bytes, const PackedByteArray &p_key, PackedByteArray &r_bytes) {
+	SaveloadCipher cipher;
+	Error err = cipher.begin_encrypt(p_bytes, p_key);
+	if (err != OK) {
+		return err;
+	}
+	cipher.process_all();
+	return cipher.finish(r_bytes);
+}
+
+static Error decrypt(const PackedByteArray &p_bytes, const PackedByteArray &p_key, PackedByteArray &r_bytes) {
+	SaveloadCipher cipher;
+	Error err = cipher.begin_decrypt(p_bytes, p_key);
+	if (err != OK) {
+		return err;
+	}
+	cipher.process_all();
+	return cipher.finish(r_bytes);
+}
+
+TEST_CASE("[Saveload][Cipher] Decrypting with the same key restores the file") {
+	const PackedByteArray plaintext = make_plaintext();
+	const PackedByteArray key = make_key("correct horse");
+	PackedByteArray encrypted;
+	REQUIRE(encrypt(plaintext, key, encrypted) == OK);
+	CHECK(SaveloadCipher::is_encrypted(encrypted));
+	CHECK(!SaveloadCipher::is_encrypted(plaintext));
+	CHECK(SaveloadCipher::check_size(encrypted, encrypted.size()) == OK);
+	CHECK(encrypted.size() == SaveloadCipher::HEADER_SIZE + plaintext.size() + 3 * SaveloadCipher::MAC_SIZE);
+	CHECK(encrypted.slice(SaveloadCipher::HEADER_SIZE, SaveloadCipher::HEADER_SIZE + 100) != plaintext.slice(0, 100));
+
+	PackedByteArray decrypted;
+	REQUIRE(decrypt(encrypted, key, decrypted) == OK);
+	CHECK(decrypted == plaintext);
+
+	// Each file has its own nonce, so the same plaintext never encrypts the same way twice.
+	PackedByteArray again;
+	REQUIRE(encrypt(plaintext, key, again) == OK);
+	CHECK(again != encrypted);
+
+	PackedByteArray empty;
+	REQUIRE(encrypt(PackedByteArray(), key, encrypted) == OK);
+	REQUIRE(decrypt(encrypted, key, empty) == OK);
+	CHECK(empty.is_empty());
+}
+
+TEST_CASE("[Saveload][Cipher] Tampered files and wrong keys are rejected") {
+	const PackedByteArray key = make_key("correct horse");
+	PackedByteArray encrypted;
+	REQUIRE(encrypt(make_plaintext(), key, encrypted) == OK);
+	PackedByteArray decrypted;
+	ERR_PRINT_OFF;
+
+	SUBCASE("Wrong key") {
+		CHECK(decrypt(encrypted, make_key("battery staple"), decrypted) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("No key") {
+		CHECK(decrypt(encrypted, PackedByteArray(), decrypted) == ERR_UNAUTHORIZED);
+	}
+	SUBCASE("Changed ciphertext") {
+		PackedByteArray corrupt = encrypted;
+		const int64_t offset = SaveloadCipher::HEADER_SIZE + SaveloadCipher::BLOCK_SIZE + SaveloadCipher::MAC_SIZE + 5;
+		corrupt.set(offset, corrupt[offset] ^ 1);
+		CHECK(decrypt(corrupt, key, decrypted) == ERR_FILE_CORRUPT);
+		CHECK(decrypted.is_empty());
+	}
+	SUBCASE("Changed header") {
+		PackedByteArray corrupt = encrypted;
+		corrupt.set(20, corrupt[20] ^ 1); // In the nonce.
+		CHECK(decrypt(corrupt, key, decrypted) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Reordered blocks") {
+		PackedByteArray corrupt = encrypted;
+		const int64_t stride = SaveloadCipher::BLOCK_SIZE + SaveloadCipher::MAC_SIZE;
+		uint8_t *w = corrupt.ptrw() + SaveloadCipher::HEADER_SIZE;
+		for (int64_t i = 0; i < stride; i++) {
+			SWAP(w[i], w[stride + i]);
+		}
+		CHECK(decrypt(corrupt, key, decrypted) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Truncated") {
+		const PackedByteArray truncated = encrypted.slice(0, encrypted.size() - 1);
+		CHECK(SaveloadCipher::check_size(truncated, truncated.size()) == ERR_FILE_CORRUPT);
+		CHECK(decrypt(truncated, key, decrypted) == ERR_FILE_CORRUPT);
+		CHECK(decrypt(encrypted.slice(0, SaveloadCipher::HEADER_SIZE - 1), key, decrypted) == ERR_FILE_CORRUPT);
+	}
+
+	ERR_PRINT_ON;
+}
+
+} // namespace TestSaveloadCipher
+
+#endif // TEST_SAVELOAD_CIPHER_H
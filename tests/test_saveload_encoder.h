@@ -0,0 +1,504 @@
+/**************************************************************************/
+/*  test_saveload_encoder.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SAVELOAD_ENCODER_H
+#define TEST_SAVELOAD_ENCODER_H
+
+#include "../src/saveload_encoder.h"
+
+#include "core/io/file_access.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestSaveloadEncoder {
+
+// The state types are only meant for SceneSaveload and its codec, so tests name them through a subclass.
+class SaveloadStateAccess : public SceneSaveload {
+public:
+	typedef SceneSaveload::SaveloadState State;
+	typedef SceneSaveload::SyncherGroup Group;
+};
+
+static PackedByteArray to_bytes(const SaveloadWriter &p_writer) {
+	PackedByteArray bytes;
+	bytes.resize(p_writer.size());
+	memcpy(bytes.ptrw(), p_writer.ptr(), p_writer.size());
+	return bytes;
+}
+
+// Writes an uncompressed file in the layout of p_version by hand, holding one spawn "Spawner/Enemy"
+// and one synchronizer "Enemy/Sync" whose :health is 42 and whose :name is "Bob". The tables
+// reference two variants, and p_variant_count other than two makes the file disagree with them.
+static PackedByteArray make_save(uint32_t p_version, uint64_t p_fingerprint, int p_variant_count = 2) {
+	const char *paths[] = { "Spawner", "Spawner/Enemy", "Enemy/Sync", ":health", ":name" };
+	const bool has_path_table = p_version >= SaveloadEncoder::VERSION_PATH_TABLE;
+	SaveloadWriter payload;
+	uint32_t section_sizes[SaveloadEncoder::SECTION_MAX] = {};
+	uint32_t section_start = 0;
+	const auto end_section = [&](SaveloadEncoder::Section p_section) {
+		section_sizes[p_section] = payload.size() - section_start;
+		section_start = payload.size();
+	};
+	const auto put_path = [&](uint32_t p_index) {
+		if (has_path_table) {
+			payload.put_u32(p_index);
+		} else {
+			payload.put_string(paths[p_index]);
+		}
+	};
+
+	payload.put_u32(1);
+	payload.put_u8(SaveloadEncoder::COLUMN_INT);
+	payload.put_u8(SceneSaveloadConfig::ENCODING_DEFAULT);
+	payload.put_u8(SaveloadEncoder::TRANSFORM_NONE);
+	payload.put_u32(sizeof(uint64_t));
+	payload.put_u64(42);
+	end_section(SaveloadEncoder::SECTION_COLUMNS);
+
+	Array variants;
+	variants.push_back(Variant()); // Spawn arguments.
+	variants.push_back("Bob");
+	variants.resize(p_variant_count);
+	const PackedByteArray variant_bytes = SaveloadEncoder::encode_variant(variants);
+	payload.put_u32(variant_bytes.size());
+	payload.put_data(variant_bytes.ptr(), variant_bytes.size());
+	end_section(SaveloadEncoder::SECTION_VARIANTS);
+
+	if (has_path_table) {
+		payload.put_u32(5);
+		for (const char *path : paths) {
+			payload.put_string(path);
+		}
+	}
+	if (p_version >= SaveloadEncoder::VERSION_RESOURCE_TABLE) {
+		payload.put_u32(0);
+	}
+	end_section(SaveloadEncoder::SECTION_PATHS);
+
+	payload.put_u32(1);
+	put_path(0);
+	payload.put_u32(1);
+	put_path(1);
+	payload.put_u32(0); // Scene index.
+	if (p_version >= SaveloadEncoder::VERSION_SPAWN_ARG_IDS) {
+		payload.put_u32(0);
+	}
+	payload.put_u32(1);
+	payload.put_u32(2); // Properties.
+	payload.put_u32(1); // Instances.
+	if (p_version >= SaveloadEncoder::VERSION_FINGERPRINTS) {
+		payload.put_u64(p_fingerprint);
+	}
+	put_path(2);
+	put_path(3);
+	payload.put_u8(SaveloadEncoder::COLUMN_INT);
+	payload.put_u8(SceneSaveloadConfig::ENCODING_DEFAULT);
+	if (p_version >= SaveloadEncoder::VERSION_PRESENCE_MASKS) {
+		payload.put_u8(0);
+	}
+	put_path(4);
+	payload.put_u8(SaveloadEncoder::COLUMN_VARIANT);
+	payload.put_u8(SceneSaveloadConfig::ENCODING_DEFAULT);
+	if (p_version >= SaveloadEncoder::VERSION_PRESENCE_MASKS) {
+		payload.put_u8(0);
+	}
+	end_section(SaveloadEncoder::SECTION_TABLES);
+
+	SaveloadWriter file;
+	file.put_u32(SaveloadEncoder::FORMAT_MAGIC);
+	file.put_u32(p_version);
+	file.put_u8(sizeof(real_t));
+	file.put_u8(SaveloadEncoder::COMPRESSION_NONE);
+	file.put_u32(payload.size());
+	if (p_version >= SaveloadEncoder::VERSION_SECTION_TABLE) {
+		uint32_t offset = 0;
+		for (int i = 0; i < SaveloadEncoder::SECTION_MAX; i++) {
+			file.put_u32(section_sizes[i]);
+			file.put_u64(SaveloadEncoder::hash_section(payload.ptr() + offset, section_sizes[i]));
+			offset += section_sizes[i];
+		}
+	}
+	if (p_version >= SaveloadEncoder::VERSION_STORED_HASH) {
+		file.put_u32(payload.size());
+		file.put_u64(0);
+	}
+	file.put_data(payload.ptr(), payload.size());
+	return to_bytes(file);
+}
+
+static void write_file(const String &p_path, const PackedByteArray &p_bytes) {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	REQUIRE(file.is_valid());
+	file->store_buffer(p_bytes.ptr(), p_bytes.size());
+}
+
+TEST_CASE("[Saveload][Encoder] Files of every supported format version decode") {
+	const SaveloadPathTable *paths = SaveloadPathTable::get_singleton();
+	REQUIRE(paths);
+	for (uint32_t version = SaveloadEncoder::MIN_FORMAT_VERSION; version <= SaveloadEncoder::FORMAT_VERSION; version++) {
+		CAPTURE(version);
+		SaveloadStateAccess::State state;
+		SaveloadDecoder decoder;
+		REQUIRE(decoder.decode(make_save(version, 7), state) == OK);
+
+		REQUIRE(state.spawner_states.size() == 1);
+		const KeyValue<uint32_t, SaveloadSpawner::SpawnerState> &spawner = *state.spawner_states.begin();
+		CHECK(paths->get_path(spawner.key) == NodePath("Spawner"));
+		REQUIRE(spawner.value.spawn_infos.size() == 1);
+		CHECK(spawner.value.spawn_infos[0].get_path() == NodePath("Spawner/Enemy"));
+		CHECK(spawner.value.spawn_infos[0].spawn_args.get_type() == Variant::NIL);
+
+		REQUIRE(state.syncher_groups.size() == 1);
+		const SaveloadStateAccess::Group &group = state.syncher_groups[0];
+		// Groups from before fingerprints are left for the registered migrations.
+		CHECK(group.fingerprint == (version >= SaveloadEncoder::VERSION_FINGERPRINTS ? 7 : 0));
+		REQUIRE(group.synchers.size() == 1);
+		CHECK(paths->get_path(group.synchers[0]) == NodePath("Enemy/Sync"));
+		REQUIRE(group.properties.size() == 2);
+		CHECK(paths->get_path(group.properties[0]) == NodePath(":health"));
+		CHECK(paths->get_path(group.properties[1]) == NodePath(":name"));
+		CHECK(group.columns[0][0] == Variant(42));
+		CHECK(group.columns[1][0] == Variant("Bob"));
+	}
+}
+
+TEST_CASE("[Saveload][Encoder] Files of unsupported format versions are rejected") {
+	SaveloadStateAccess::State state;
+	SaveloadDecoder decoder;
+	ERR_PRINT_OFF;
+	CHECK(decoder.decode(make_save(SaveloadEncoder::FORMAT_VERSION + 1, 0), state) == ERR_FILE_UNRECOGNIZED);
+	PackedByteArray bytes = make_save(SaveloadEncoder::MIN_FORMAT_VERSION, 0);
+	const uint32_t old_version = SaveloadEncoder::MIN_FORMAT_VERSION - 1;
+	memcpy(bytes.ptrw() + sizeof(uint32_t), &old_version, sizeof(old_version));
+	CHECK(decoder.decode(bytes, state) == ERR_FILE_UNRECOGNIZED);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Saveload][Encoder] Values that could not be read stay missing") {
+	SaveloadPathTable *paths = SaveloadPathTable::get_singleton();
+	REQUIRE(paths);
+	SaveloadStateAccess::State state;
+	LocalVector<uint32_t> properties;
+	properties.push_back(paths->intern(NodePath(":health")));
+	state.syncher_groups.push_back(SaveloadStateAccess::Group(properties));
+	SaveloadStateAccess::Group &group = state.syncher_groups[0];
+	group.resize_missing();
+	for (int i = 0; i < 10; i++) {
+		const uint32_t instance = group.add_syncher(paths->intern(NodePath(vformat("Enemy%d/Sync", i))));
+		group.columns[0][instance] = i;
+		group.missing[0][instance] = i == 3 || i == 9;
+	}
+
+	SaveloadEncoder encoder;
+	PackedByteArray bytes;
+	REQUIRE(encoder.encode(state, bytes) == OK);
+	SaveloadStateAccess::State decoded;
+	SaveloadDecoder decoder;
+	REQUIRE(decoder.decode(bytes, decoded) == OK);
+	REQUIRE(decoded.syncher_groups.size() == 1);
+	const SaveloadStateAccess::Group &decoded_group = decoded.syncher_groups[0];
+	REQUIRE(decoded_group.synchers.size() == 10);
+	for (uint32_t i = 0; i < 10; i++) {
+		CAPTURE(i);
+		CHECK(decoded_group.is_missing(0, i) == (i == 3 || i == 9));
+		if (!decoded_group.is_missing(0, i)) {
+			// The missing values are left out, so the column is still read in step.
+			CHECK(decoded_group.columns[0][i] == Variant(i));
+		}
+	}
+}
+
+TEST_CASE("[Saveload][Encoder] Encoding and decoding keep every value") {
+	SaveloadPathTable *paths = SaveloadPathTable::get_singleton();
+	REQUIRE(paths);
+	SaveloadStateAccess::State state;
+	const uint32_t spawner_id = paths->intern(NodePath("Spawner"));
+	SaveloadSpawner::SpawnerState &spawner = state.spawner_states.insert(spawner_id, SaveloadSpawner::SpawnerState())->value;
+	Dictionary args;
+	args["team"] = 2;
+	for (int i = 0; i < 4; i++) {
+		// Every other spawn shares its arguments, which are written once.
+		spawner.push_back(SaveloadSpawner::SpawnInfo(paths->intern(NodePath(vformat("Spawner/Enemy%d", i))), i % 2, i % 2 ? Variant(args) : Variant(i)));
+	}
+
+	const Variant values[] = {
+		int64_t(-7),
+		3.25,
+		Vector2(1, -2),
+		Vector3(0.5, 1.5, -2.5),
+		Quaternion(0, 0, 0.6, 0.8),
+		Transform3D(Basis(Vector3(0, 1, 0), 0.5), Vector3(10, 20, 30)),
+		Color(0.1, 0.2, 0.3, 0.4),
+		String("untyped"),
+	};
+	const int value_count = sizeof(values) / sizeof(values[0]);
+	LocalVector<uint32_t> properties;
+	for (int i = 0; i < value_count; i++) {
+		properties.push_back(paths->intern(NodePath(vformat(":property%d", i))));
+	}
+	state.syncher_groups.push_back(SaveloadStateAccess::Group(properties));
+	SaveloadStateAccess::Group &group = state.syncher_groups[0];
+	for (int i = 0; i < 3; i++) {
+		const uint32_t instance = group.add_syncher(paths->intern(NodePath(vformat("Spawner/Enemy%d/Sync", i))));
+		for (int j = 0; j < value_count; j++) {
+			group.columns[j][instance] = values[j];
+		}
+	}
+
+	SaveloadEncoder encoder;
+	PackedByteArray bytes;
+	REQUIRE(encoder.encode(state, bytes) == OK);
+	// The encoder keeps its buffers between saves, which must not leak one save into the next.
+	PackedByteArray again;
+	REQUIRE(encoder.encode(state, again) == OK);
+	CHECK(again == bytes);
+
+	SaveloadStateAccess::State decoded;
+	SaveloadDecoder decoder;
+	REQUIRE(decoder.decode(bytes, decoded) == OK);
+
+	REQUIRE(decoded.spawner_states.has(spawner_id));
+	const LocalVector<SaveloadSpawner::SpawnInfo> &spawns = decoded.spawner_states[spawner_id].spawn_infos;
+	REQUIRE(spawns.size() == 4);
+	for (uint32_t i = 0; i < 4; i++) {
+		CAPTURE(i);
+		CHECK(spawns[i].get_path() == spawner.spawn_infos[i].get_path());
+		CHECK(spawns[i].scene_index == spawner.spawn_infos[i].scene_index);
+		CHECK(spawns[i].spawn_args == spawner.spawn_infos[i].spawn_args);
+	}
+
+	REQUIRE(decoded.syncher_groups.size() == 1);
+	const SaveloadStateAccess::Group &decoded_group = decoded.syncher_groups[0];
+	REQUIRE(decoded_group.synchers.size() == 3);
+	REQUIRE(decoded_group.properties.size() == (uint32_t)value_count);
+	for (uint32_t i = 0; i < 3; i++) {
+		CHECK(decoded_group.synchers[i] == group.synchers[i]);
+		for (int j = 0; j < value_count; j++) {
+			CAPTURE(j);
+			CHECK(decoded_group.properties[j] == group.properties[j]);
+			CHECK(decoded_group.columns[j][i] == values[j]);
+			CHECK(!decoded_group.is_missing(j, i));
+		}
+	}
+}
+
+// Saves p_values as one property of as many synchronizers, stored with p_encoding, and returns them as loaded.
+static LocalVector<Variant> encode_property(const Vector<Variant> &p_values, SceneSaveloadConfig::PropertyEncoding p_encoding, const Vector2 &p_range = Vector2(0, 1)) {
+	SaveloadPathTable *paths = SaveloadPathTable::get_singleton();
+	const NodePath property(":value");
+	Ref<SceneSaveloadConfig> config;
+	config.instantiate();
+	config->add_property(property);
+	config->property_set_type(property, p_values[0].get_type());
+	config->property_set_encoding(property, p_encoding);
+	config->property_set_encoding_range(property, p_range);
+
+	SaveloadStateAccess::State state;
+	LocalVector<uint32_t> properties;
+	properties.push_back(paths->intern(property));
+	state.syncher_groups.push_back(SaveloadStateAccess::Group(properties));
+	SaveloadStateAccess::Group &group = state.syncher_groups[0];
+	group.config = config;
+	for (int i = 0; i < p_values.size(); i++) {
+		const uint32_t instance = group.add_syncher(paths->intern(NodePath(vformat("Node%d/Sync", i))));
+		group.columns[0][instance] = p_values[i];
+	}
+
+	SaveloadEncoder encoder;
+	PackedByteArray bytes;
+	SaveloadStateAccess::State decoded;
+	SaveloadDecoder decoder;
+	if (encoder.encode(state, bytes) != OK || decoder.decode(bytes, decoded) != OK || decoded.syncher_groups.size() != 1) {
+		return LocalVector<Variant>();
+	}
+	return decoded.syncher_groups[0].columns[0];
+}
+
+static bool is_close(real_t p_value, real_t p_expected, real_t p_tolerance) {
+	return Math::abs(p_value - p_expected) <= p_tolerance;
+}
+
+TEST_CASE("[Saveload][Encoder] Half floats keep their special values") {
+	const Vector<Variant> values = { 1.0, -0.1, 65504.0, 1e-5, 1e-9, 1e5, -1e5, Math_NAN, Math_INF };
+	const LocalVector<Variant> decoded = encode_property(values, SceneSaveloadConfig::ENCODING_HALF);
+	REQUIRE(decoded.size() == (uint32_t)values.size());
+	CHECK((double)decoded[0] == 1.0);
+	CHECK(is_close(decoded[1], -0.1, 0.1 / 1024));
+	CHECK((double)decoded[2] == 65504.0); // The largest finite half.
+	// Subnormal halves are spaced 2^-24 apart, and anything below half of that flushes to zero.
+	CHECK(is_close(decoded[3], 1e-5, 1.0 / (1 << 25)));
+	CHECK((double)decoded[4] == 0.0);
+	CHECK(Math::is_inf((double)decoded[5]));
+	CHECK((double)decoded[5] > 0);
+	CHECK(Math::is_inf((double)decoded[6]));
+	CHECK((double)decoded[6] < 0);
+	CHECK(Math::is_nan((double)decoded[7]));
+	CHECK(Math::is_inf((double)decoded[8]));
+}
+
+TEST_CASE("[Saveload][Encoder] Fixed-point values are clamped to their range") {
+	const Vector2 range(-10, 10);
+	const real_t step = (range.y - range.x) / 65535;
+	const Vector<Variant> values = { Vector3(1.5, -50, 50), Vector3(-10, 10, 0), Vector3(Math_NAN, 9.99, -3.25) };
+	const LocalVector<Variant> decoded = encode_property(values, SceneSaveloadConfig::ENCODING_FIXED_16, range);
+	REQUIRE(decoded.size() == (uint32_t)values.size());
+	const Vector3 first = decoded[0];
+	CHECK(is_close(first.x, 1.5, step));
+	CHECK(first.y == range.x);
+	CHECK(first.z == range.y);
+	const Vector3 second = decoded[1];
+	CHECK(second.x == range.x);
+	CHECK(second.y == range.y);
+	CHECK(is_close(second.z, 0, step));
+	// NaN has no place in the range, so it is stored as the minimum.
+	const Vector3 third = decoded[2];
+	CHECK(third.x == range.x);
+	CHECK(is_close(third.y, 9.99, step));
+	CHECK(is_close(third.z, -3.25, step));
+}
+
+TEST_CASE("[Saveload][Encoder] Smallest-three quaternions keep their rotation") {
+	const Quaternion negative_largest = Quaternion(0.1, -0.9, 0.2, 0.3).normalized();
+	const Quaternion rotation = Quaternion(Vector3(1, 2, 3).normalized(), 2.0);
+	const Vector<Variant> values = { negative_largest, rotation, -rotation, Quaternion(), Quaternion(0, 0, 0, 0) };
+	const LocalVector<Variant> decoded = encode_property(values, SceneSaveloadConfig::ENCODING_SMALLEST_THREE);
+	REQUIRE(decoded.size() == (uint32_t)values.size());
+	// The largest component is stored positive, so q may come back as -q, the same rotation.
+	const Quaternion first = decoded[0];
+	CHECK(first.is_normalized());
+	CHECK(first.y > 0);
+	CHECK(is_close(Math::abs(first.dot(negative_largest)), 1, 1e-3));
+	const Quaternion second = decoded[1];
+	CHECK(is_close(Math::abs(second.dot(rotation)), 1, 1e-3));
+	CHECK((Quaternion)decoded[2] == second);
+	// The 10-bit steps have no exact zero, so even the identity comes back slightly off.
+	CHECK(is_close(((Quaternion)decoded[3]).w, 1, 1e-3));
+	// A zero quaternion is no rotation at all, and is stored as the identity.
+	CHECK(is_close(((Quaternion)decoded[4]).w, 1, 1e-3));
+}
+
+TEST_CASE("[Saveload][Encoder] Byte colors are rounded and clamped") {
+	const Vector<Variant> values = { Color(0.2, 0.4, 0.6, 1), Color(1.5, -0.5, 0, 0.5) };
+	const LocalVector<Variant> decoded = encode_property(values, SceneSaveloadConfig::ENCODING_COLOR_BYTE);
+	REQUIRE(decoded.size() == (uint32_t)values.size());
+	const Color first = decoded[0];
+	CHECK(is_close(first.r, 0.2, 0.51 / 255));
+	CHECK(is_close(first.g, 0.4, 0.51 / 255));
+	CHECK(is_close(first.b, 0.6, 0.51 / 255));
+	CHECK(first.a == 1);
+	const Color second = decoded[1];
+	CHECK(second.r == 1);
+	CHECK(second.g == 0);
+	CHECK(second.b == 0);
+	CHECK(is_close(second.a, 0.5, 0.51 / 255));
+}
+
+TEST_CASE("[Saveload][Encoder] Corrupt files are rejected") {
+	SaveloadStateAccess::State state;
+	SaveloadDecoder decoder;
+	const PackedByteArray bytes = make_save(SaveloadEncoder::FORMAT_VERSION, 0);
+	// make_save() starts its payload with a column directory of a single 8-byte column.
+	const int64_t column_offset = SaveloadEncoder::HEADER_SIZE + sizeof(uint32_t);
+	const int64_t variant_offset = column_offset + 3 + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+	ERR_PRINT_OFF;
+
+	SUBCASE("Truncated") {
+		CHECK(decoder.decode(bytes.slice(0, bytes.size() - 1), state) == ERR_FILE_CORRUPT);
+		CHECK(decoder.decode(bytes.slice(0, SaveloadEncoder::HEADER_SIZE - 1), state) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Not a saveload file") {
+		PackedByteArray corrupt = bytes;
+		corrupt.set(0, 0);
+		CHECK(decoder.decode(corrupt, state) == ERR_FILE_UNRECOGNIZED);
+	}
+	SUBCASE("Invalid column") {
+		PackedByteArray corrupt = bytes;
+		corrupt.set(column_offset, SaveloadEncoder::COLUMN_MAX);
+		CHECK(decoder.decode(corrupt, state) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Undecodable variant values") {
+		PackedByteArray corrupt = bytes;
+		corrupt.set(variant_offset, 0xFF);
+		CHECK(decoder.decode(corrupt, state) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Tables referencing more values than the file holds") {
+		CHECK(decoder.decode(make_save(SaveloadEncoder::FORMAT_VERSION, 0, 1), state) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Values no table references") {
+		CHECK(decoder.decode(make_save(SaveloadEncoder::FORMAT_VERSION, 0, 3), state) == ERR_FILE_CORRUPT);
+	}
+	SUBCASE("Changed bytes fail validation") {
+		const String path = TestUtils::get_temp_path("saveload_corrupt.svld");
+		PackedByteArray corrupt = bytes;
+		corrupt.set(corrupt.size() - 1, corrupt[corrupt.size() - 1] ^ 1);
+		write_file(path, bytes);
+		CHECK(SaveloadDecoder::validate(path) == OK);
+		write_file(path, corrupt);
+		CHECK(SaveloadDecoder::validate(path) == ERR_FILE_CORRUPT);
+	}
+
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Saveload][Encoder] Compressed files validate without decompressing") {
+	const String path = TestUtils::get_temp_path("saveload_compressed.svld");
+	PackedByteArray bytes = make_save(SaveloadEncoder::FORMAT_VERSION, 0);
+	const PackedByteArray uncompressed = bytes;
+	REQUIRE(SaveloadEncoder::compress(bytes, FileAccess::COMPRESSION_ZSTD) == OK);
+	CHECK(bytes.ptr()[9] == FileAccess::COMPRESSION_ZSTD);
+
+	write_file(path, bytes);
+	CHECK(SaveloadDecoder::validate(path) == OK);
+
+	SUBCASE("A changed byte is found") {
+		PackedByteArray corrupt = bytes;
+		corrupt.set(corrupt.size() - 1, corrupt[corrupt.size() - 1] ^ 1);
+		write_file(path, corrupt);
+		ERR_PRINT_OFF;
+		CHECK(SaveloadDecoder::validate(path) == ERR_FILE_CORRUPT);
+		ERR_PRINT_ON;
+	}
+	SUBCASE("A truncated file is found") {
+		write_file(path, bytes.slice(0, bytes.size() - 1));
+		ERR_PRINT_OFF;
+		CHECK(SaveloadDecoder::validate(path) == ERR_FILE_CORRUPT);
+		ERR_PRINT_ON;
+	}
+	SUBCASE("Decompressing restores the encoded file") {
+		PackedByteArray decompressed = bytes;
+		REQUIRE(SaveloadDecoder::decompress(decompressed) == OK);
+		CHECK(decompressed == uncompressed);
+	}
+}
+
+} // namespace TestSaveloadEncoder
+
+#endif // TEST_SAVELOAD_ENCODER_H
@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*  test_saveload_simd.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SAVELOAD_SIMD_H
+#define TEST_SAVELOAD_SIMD_H
+
+#include "../src/saveload_simd.h"
+
+#include "core/templates/vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSaveloadSimd {
+
+// Sizes around each vector width, so every kernel ends on a tail of every length.
+static const uint32_t sizes[] = { 0, 1, 2, 3, 7, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 95, 127, 128, 129, 255, 257, 1000, 4099 };
+
+static Vector<uint8_t> make_bytes(uint32_t p_size) {
+	Vector<uint8_t> bytes;
+	bytes.resize(p_size);
+	uint8_t *w = bytes.ptrw();
+	uint32_t state = p_size + 1;
+	for (uint32_t i = 0; i < p_size; i++) {
+		state = state * 1664525 + 1013904223;
+		w[i] = state >> 24;
+	}
+	return bytes;
+}
+
+// The transforms as documented, one byte at a time, for the vector paths to be checked against.
+static void xor_neighbours_reference(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_stride) {
+	for (uint32_t i = 0; i < p_size; i++) {
+		r_dst[i] = i < p_stride ? p_src[i] : p_src[i] ^ p_src[i - p_stride];
+	}
+}
+
+static void shuffle_reference(const uint8_t *p_src, uint8_t *r_dst, uint32_t p_size, uint32_t p_width) {
+	const uint32_t count = p_size / p_width;
+	for (uint32_t i = 0; i < count; i++) {
+		for (uint32_t j = 0; j < p_width; j++) {
+			r_dst[j * count + i] = p_src[i * p_width + j];
+		}
+	}
+	for (uint32_t i = count * p_width; i < p_size; i++) {
+		r_dst[i] = p_src[i];
+	}
+}
+
+TEST_CASE("[Saveload][Simd] XOR with neighbours matches the scalar transform") {
+	const uint32_t strides[] = { 1, 2, 3, 4, 8, 12, 16, 24, 36, 48 };
+	for (const uint32_t size : sizes) {
+		const Vector<uint8_t> source = make_bytes(size);
+		for (const uint32_t stride : strides) {
+			CAPTURE(size);
+			CAPTURE(stride);
+			Vector<uint8_t> expected;
+			expected.resize(size);
+			xor_neighbours_reference(source.ptr(), expected.ptrw(), size, stride);
+			Vector<uint8_t> transformed;
+			transformed.resize(size);
+			SaveloadSimd::xor_neighbours(source.ptr(), transformed.ptrw(), size, stride);
+			CHECK(transformed == expected);
+
+			SaveloadSimd::unxor_neighbours(transformed.ptrw(), size, stride);
+			CHECK(transformed == source);
+		}
+	}
+}
+
+TEST_CASE("[Saveload][Simd] Shuffling matches the scalar transform") {
+	// 2 and 4 have vector paths, the others only the scalar one.
+	const uint32_t widths[] = { 1, 2, 3, 4, 8 };
+	for (const uint32_t size : sizes) {
+		const Vector<uint8_t> source = make_bytes(size);
+		for (const uint32_t width : widths) {
+			CAPTURE(size);
+			CAPTURE(width);
+			Vector<uint8_t> expected;
+			expected.resize(size);
+			shuffle_reference(source.ptr(), expected.ptrw(), size, width);
+			Vector<uint8_t> shuffled;
+			shuffled.resize(size);
+			SaveloadSimd::shuffle(source.ptr(), shuffled.ptrw(), size, width);
+			CHECK(shuffled == expected);
+
+			Vector<uint8_t> unshuffled;
+			unshuffled.resize(size);
+			SaveloadSimd::unshuffle(shuffled.ptr(), unshuffled.ptrw(), size, width);
+			CHECK(unshuffled == source);
+		}
+	}
+}
+
+} // namespace TestSaveloadSimd
+
+#endif // TEST_SAVELOAD_SIMD_H